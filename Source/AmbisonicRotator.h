@@ -0,0 +1,172 @@
+/*
+  ==============================================================================
+
+	Soundfield rotation for a first-order ambisonic (ACN/SN3D) bus.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "StereoMatrixKernel.h"
+
+// ACN channel order
+enum AmbisonicChannel {
+	ambisonicW,
+	ambisonicY,
+	ambisonicZ,
+	ambisonicX,
+	numAmbisonicChannels
+};
+
+//==============================================================================
+/**
+	SN3D scales the three first-order components alike, so they rotate as a plain (x, y, z)
+	vector and W, the omni component, is left alone. The 4x4 rotation matrix is therefore
+	stored as its 3x3 block.
+
+	The processor computes a target matrix per block, or per control interval while the
+	angles are smoothing, and process() interpolates linearly from the previous matrix to it
+	across the chunk. Both the constant and the interpolated matrix run through SIMDRegister,
+	three loads, nine multiply-adds and three stores per vector.
+*/
+class AmbisonicRotator {
+public:
+	// Row-major, rows and columns in x, y, z order
+	using Matrix = std::array<double, 9>;
+
+	static constexpr Matrix IDENTITY{ 1.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0 };
+
+	// Positive yaw turns the scene to the left, positive pitch raises the front and positive roll
+	// raises the left side. Applied as roll, then pitch, then yaw; wet blends towards the identity.
+	static Matrix makeMatrix(double yawRadians, double pitchRadians, double rollRadians, double wet) {
+		const double cy = std::cos(yawRadians), sy = std::sin(yawRadians);
+		const double cp = std::cos(pitchRadians), sp = std::sin(pitchRadians);
+		const double cr = std::cos(rollRadians), sr = std::sin(rollRadians);
+
+		// Rz(yaw) * Ry(-pitch) * Rx(roll)
+		const Matrix rotation{
+			cy * cp,	-cy * sp * sr - sy * cr,	-cy * sp * cr + sy * sr,
+			sy * cp,	-sy * sp * sr + cy * cr,	-sy * sp * cr - cy * sr,
+			sp,			cp * sr,					cp * cr
+		};
+
+		Matrix matrix;
+		for (size_t elementIdx = 0; elementIdx < matrix.size(); elementIdx++)
+			matrix[elementIdx] = wet * rotation[elementIdx] + (1.0 - wet) * IDENTITY[elementIdx];
+		return matrix;
+	}
+
+	void reset(const Matrix& matrix) {
+		current = matrix;
+	}
+
+	//==============================================================================
+	// Rotates numSamples from startSample of the four ACN channels, ending on target
+	template <typename T>
+	void process(T* const* channels, int startSample, int numSamples, const Matrix& target) noexcept {
+		T* xPtr = channels[ambisonicX] + startSample;
+		T* yPtr = channels[ambisonicY] + startSample;
+		T* zPtr = channels[ambisonicZ] + startSample;
+
+		if (target == current) {
+			// At rest on the identity (bypassed, or every angle at 0) the input already is the output
+			if (current != IDENTITY)
+				processStatic(xPtr, yPtr, zPtr, numSamples);
+			return;
+		}
+
+		processRamped(xPtr, yPtr, zPtr, numSamples, target);
+		current = target;
+	}
+
+private:
+	Matrix current = IDENTITY;
+
+	template <typename T>
+	using Vec = StereoMatrixKernel::Vec<T>;
+
+	// (x, y, z) = m * (x, y, z), with m a row-major 3x3 matrix
+	template <typename V, typename Coefficients>
+	static void rotate(V& x, V& y, V& z, const Coefficients& m) noexcept {
+		const V outX = m[0] * x + m[1] * y + m[2] * z;
+		const V outY = m[3] * x + m[4] * y + m[5] * z;
+		const V outZ = m[6] * x + m[7] * y + m[8] * z;
+		x = outX;
+		y = outY;
+		z = outZ;
+	}
+
+	template <typename T>
+	void processStatic(T* xPtr, T* yPtr, T* zPtr, int numSamples) const noexcept {
+		constexpr int width = static_cast<int>(Vec<T>::size());
+
+		std::array<T, 9> scalars;
+		std::array<Vec<T>, 9> vectors;
+		for (size_t elementIdx = 0; elementIdx < scalars.size(); elementIdx++) {
+			scalars[elementIdx] = static_cast<T>(current[elementIdx]);
+			vectors[elementIdx] = Vec<T>::expand(scalars[elementIdx]);
+		}
+
+		int sampleIdx = 0;
+		for (; sampleIdx + width <= numSamples; sampleIdx += width) {
+			auto x = StereoMatrixKernel::load(xPtr + sampleIdx);
+			auto y = StereoMatrixKernel::load(yPtr + sampleIdx);
+			auto z = StereoMatrixKernel::load(zPtr + sampleIdx);
+			rotate(x, y, z, vectors);
+			StereoMatrixKernel::store(xPtr + sampleIdx, x);
+			StereoMatrixKernel::store(yPtr + sampleIdx, y);
+			StereoMatrixKernel::store(zPtr + sampleIdx, z);
+		}
+
+		for (; sampleIdx < numSamples; sampleIdx++)
+			rotate(xPtr[sampleIdx], yPtr[sampleIdx], zPtr[sampleIdx], scalars);
+	}
+
+	// Sample i uses current + (i + 1) / numSamples * (target - current), so the chunk ends exactly on target
+	template <typename T>
+	void processRamped(T* xPtr, T* yPtr, T* zPtr, int numSamples, const Matrix& target) const noexcept {
+		constexpr int width = static_cast<int>(Vec<T>::size());
+
+		std::array<T, width> laneOffsets;
+		for (int lane = 0; lane < width; lane++) laneOffsets[static_cast<size_t>(lane)] = static_cast<T>(lane + 1);
+		const auto lanes = StereoMatrixKernel::load(laneOffsets.data());
+
+		// Running per-lane coefficients, moved on by one vector's worth of steps per iteration
+		std::array<T, 9> steps;
+		std::array<Vec<T>, 9> vectors, vectorSteps;
+		for (size_t elementIdx = 0; elementIdx < steps.size(); elementIdx++) {
+			steps[elementIdx] = static_cast<T>((target[elementIdx] - current[elementIdx]) / numSamples);
+			vectors[elementIdx] = Vec<T>::expand(static_cast<T>(current[elementIdx])) + lanes * steps[elementIdx];
+			vectorSteps[elementIdx] = Vec<T>::expand(steps[elementIdx] * static_cast<T>(width));
+		}
+
+		int sampleIdx = 0;
+		for (; sampleIdx + width <= numSamples; sampleIdx += width) {
+			auto x = StereoMatrixKernel::load(xPtr + sampleIdx);
+			auto y = StereoMatrixKernel::load(yPtr + sampleIdx);
+			auto z = StereoMatrixKernel::load(zPtr + sampleIdx);
+			rotate(x, y, z, vectors);
+			StereoMatrixKernel::store(xPtr + sampleIdx, x);
+			StereoMatrixKernel::store(yPtr + sampleIdx, y);
+			StereoMatrixKernel::store(zPtr + sampleIdx, z);
+
+			for (size_t elementIdx = 0; elementIdx < vectors.size(); elementIdx++)
+				vectors[elementIdx] += vectorSteps[elementIdx];
+		}
+
+		// The tail is computed from the ends again, so the running sums leave no drift on the last sample
+		std::array<T, 9> scalars;
+		for (; sampleIdx < numSamples; sampleIdx++) {
+			const double position = static_cast<double>(sampleIdx + 1) / numSamples;
+			for (size_t elementIdx = 0; elementIdx < scalars.size(); elementIdx++)
+				scalars[elementIdx] = static_cast<T>(current[elementIdx] + position * (target[elementIdx] - current[elementIdx]));
+
+			rotate(xPtr[sampleIdx], yPtr[sampleIdx], zPtr[sampleIdx], scalars);
+		}
+	}
+
+	//==============================================================================
+	JUCE_LEAK_DETECTOR(AmbisonicRotator)
+};
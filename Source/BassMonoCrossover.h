@@ -0,0 +1,190 @@
+/*
+  ==============================================================================
+
+	Linkwitz-Riley crossover that splits a stereo pair into two high bands
+	and one mono low band.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "StereoMatrixKernel.h"
+
+enum class CrossoverSlope {
+	lr2,	// 12 dB/oct, two cascaded one-pole stages
+	lr4		// 24 dB/oct, two cascaded Butterworth state variable stages
+};
+
+//==============================================================================
+/**
+	By linearity the low band of L and R summed to mono is the low pass of the mid signal, so
+	only three filters run: high pass on L and R, low pass on (L + R) / 2. They are the lanes
+	[L, R, mid] of SIMDRegisters that every stage updates in lockstep: one register for floats,
+	and for doubles one with AVX or two with SSE/NEON. Each stage hands the next one its high
+	pass in the L and R lanes and its low pass in the mid lane, picked with a bitwise mask.
+
+	Topology-preserving transform filters keep the response stable when the cutoff moves.
+*/
+template <typename T>
+class BassMonoCrossover {
+public:
+	//==============================================================================
+	void prepare(double newSampleRate) {
+		sampleRate = newSampleRate;
+		cutoff = 0;
+		reset();
+	}
+
+	void reset() {
+		for (auto& stage : stages) {
+			stage.s1.fill(Vec::expand(0));
+			stage.s2.fill(Vec::expand(0));
+		}
+	}
+
+	// Cheap to call every block; coefficients only change with the parameters
+	void setParameters(float cutoffHz, CrossoverSlope newSlope) {
+		if (newSlope != slope) reset();
+		slope = newSlope;
+
+		if (cutoffHz == cutoff) return;
+		cutoff = cutoffHz;
+
+		// Keep the prewarped cutoff clear of Nyquist
+		const double limitedCutoff = juce::jmin(static_cast<double>(cutoffHz), sampleRate * 0.45);
+		const T g = static_cast<T>(std::tan(juce::MathConstants<double>::pi * limitedCutoff / sampleRate));
+
+		onePoleGain = g / (1 + g);
+
+		// Butterworth: 1/Q = sqrt(2)
+		constexpr T inverseQ = juce::MathConstants<T>::sqrt2;
+		svfG = g;
+		svfInverseQPlusG = inverseQ + g;
+		svfH = 1 / (1 + inverseQ * g + g * g);
+	}
+
+	//==============================================================================
+	// Writes both high bands and the mono low band of a chunk. LR2 high bands come out inverted,
+	// which is what makes LR2 low + high sum to an allpass instead of notching at the cutoff.
+	void process(const T* leftPtr, const T* rightPtr, T* highLeftPtr, T* highRightPtr, T* lowPtr, int numSamples) {
+		if (slope == CrossoverSlope::lr2)
+			processSamples<CrossoverSlope::lr2>(leftPtr, rightPtr, highLeftPtr, highRightPtr, lowPtr, numSamples);
+		else
+			processSamples<CrossoverSlope::lr4>(leftPtr, rightPtr, highLeftPtr, highRightPtr, lowPtr, numSamples);
+	}
+
+private:
+	//==============================================================================
+	using Vec = StereoMatrixKernel::Vec<T>;
+	using Mask = typename Vec::vMaskType;
+
+	enum Lane {
+		leftLane,
+		rightLane,
+		midLane,
+		numLanes
+	};
+
+	static constexpr int LANES_PER_REGISTER = static_cast<int>(Vec::size());
+	static constexpr int NUM_REGISTERS = (numLanes + LANES_PER_REGISTER - 1) / LANES_PER_REGISTER;
+	using Lanes = std::array<Vec, NUM_REGISTERS>;
+
+	struct Stage {
+		Lanes s1{};
+		Lanes s2{};
+	};
+
+	double sampleRate = 44100.0;
+	float cutoff = 0.0f;
+	CrossoverSlope slope = CrossoverSlope::lr4;
+
+	T onePoleGain = 0;
+	T svfG = 0, svfInverseQPlusG = 0, svfH = 0;
+	Stage stages[2];
+
+	// All bits set in the L and R lanes: high pass there, low pass everywhere else
+	std::array<Mask, NUM_REGISTERS> highMask = [] {
+		std::array<Mask, NUM_REGISTERS> masks;
+		for (int registerIdx = 0; registerIdx < NUM_REGISTERS; registerIdx++) {
+			masks[static_cast<size_t>(registerIdx)] = Mask::expand(0);
+			for (int lane : { leftLane, rightLane })
+				if (lane / LANES_PER_REGISTER == registerIdx)
+					masks[static_cast<size_t>(registerIdx)].set(static_cast<size_t>(lane % LANES_PER_REGISTER), static_cast<typename Mask::ElementType>(~0ull));
+		}
+		return masks;
+	}();
+
+	Vec select(const Vec& highPass, const Vec& lowPass, size_t registerIdx) const {
+		const Mask high = highMask[registerIdx];
+		return (highPass & high) + (lowPass & ~high);
+	}
+
+	static T getLane(const Lanes& x, int lane) {
+		return x[static_cast<size_t>(lane / LANES_PER_REGISTER)].get(static_cast<size_t>(lane % LANES_PER_REGISTER));
+	}
+
+	template <CrossoverSlope type>
+	void processSamples(const T* leftPtr, const T* rightPtr, T* highLeftPtr, T* highRightPtr, T* lowPtr, int numSamples) {
+		std::array<T, NUM_REGISTERS * LANES_PER_REGISTER> input{};
+
+		for (int sampleIdx = 0; sampleIdx < numSamples; sampleIdx++) {
+			input[leftLane] = leftPtr[sampleIdx];
+			input[rightLane] = rightPtr[sampleIdx];
+			input[midLane] = (leftPtr[sampleIdx] + rightPtr[sampleIdx]) * static_cast<T>(0.5);
+
+			Lanes x;
+			for (size_t registerIdx = 0; registerIdx < x.size(); registerIdx++)
+				x[registerIdx] = StereoMatrixKernel::load(input.data() + registerIdx * LANES_PER_REGISTER);
+
+			for (auto& stage : stages) {
+				if constexpr (type == CrossoverSlope::lr2)
+					x = processOnePole(stage, x);
+				else
+					x = processStateVariable(stage, x);
+			}
+
+			constexpr T highSign = type == CrossoverSlope::lr2 ? -1 : 1;
+			highLeftPtr[sampleIdx] = getLane(x, leftLane) * highSign;
+			highRightPtr[sampleIdx] = getLane(x, rightLane) * highSign;
+			lowPtr[sampleIdx] = getLane(x, midLane);
+		}
+	}
+
+	Lanes processOnePole(Stage& stage, const Lanes& x) const {
+		Lanes y;
+
+		for (size_t registerIdx = 0; registerIdx < y.size(); registerIdx++) {
+			Vec& s1 = stage.s1[registerIdx];
+			const Vec v = (x[registerIdx] - s1) * onePoleGain;
+			const Vec lowPass = v + s1;
+			s1 = lowPass + v;
+
+			y[registerIdx] = select(x[registerIdx] - lowPass, lowPass, registerIdx);
+		}
+
+		return y;
+	}
+
+	Lanes processStateVariable(Stage& stage, const Lanes& x) const {
+		Lanes y;
+
+		for (size_t registerIdx = 0; registerIdx < y.size(); registerIdx++) {
+			Vec& s1 = stage.s1[registerIdx];
+			Vec& s2 = stage.s2[registerIdx];
+			const Vec highPass = (x[registerIdx] - s1 * svfInverseQPlusG - s2) * svfH;
+			const Vec bandPass = highPass * svfG + s1;
+			s1 = highPass * svfG + bandPass;
+			const Vec lowPass = bandPass * svfG + s2;
+			s2 = bandPass * svfG + lowPass;
+
+			y[registerIdx] = select(highPass, lowPass, registerIdx);
+		}
+
+		return y;
+	}
+
+	//==============================================================================
+	JUCE_LEAK_DETECTOR(BassMonoCrossover)
+};
@@ -0,0 +1,107 @@
+/*
+  ==============================================================================
+
+	Compact binary encoding of the plugin state.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+	Layout, all little-endian:
+
+		uint32	MAGIC ("LPst")
+		uint16	version
+		uint16	number of parameters
+		then per parameter: uint32 FNV-1a hash of the parameter ID, float32 plain value
+
+	Encoding writes straight into the host's MemoryBlock, so a save costs no allocation beyond
+	the destination itself. Parameters are matched by ID hash rather than position, so adding,
+	removing or reordering parameters keeps old states loadable; unknown hashes are skipped.
+	Chunks without the magic are handed back to the XML loader (states saved by earlier versions).
+*/
+namespace BinaryState {
+	constexpr juce::uint32 MAGIC = 0x7473504c;	// "LPst" read as little-endian
+	constexpr juce::uint16 VERSION = 1;
+	constexpr size_t HEADER_SIZE = 8;
+	constexpr size_t ENTRY_SIZE = 8;
+
+	struct Entry {
+		juce::uint32 idHash = 0;
+		juce::RangedAudioParameter* parameter = nullptr;
+	};
+
+	// Stable across platforms, compilers and JUCE versions, unlike String::hashCode
+	inline juce::uint32 hashParameterID(const juce::String& parameterID) noexcept {
+		juce::uint32 hash = 2166136261u;
+		for (auto ptr = parameterID.toUTF8(); *ptr != 0; ++ptr) {
+			hash ^= static_cast<juce::uint8>(*ptr);
+			hash *= 16777619u;
+		}
+		return hash;
+	}
+
+	inline bool isBinaryState(const void* data, int sizeInBytes) noexcept {
+		return sizeInBytes >= static_cast<int>(HEADER_SIZE) && juce::ByteOrder::littleEndianInt(data) == MAGIC;
+	}
+
+	//==============================================================================
+	inline void write(juce::MemoryBlock& destData, const std::vector<Entry>& entries) {
+		destData.setSize(HEADER_SIZE + ENTRY_SIZE * entries.size(), false);
+		auto* bytes = static_cast<char*>(destData.getData());
+
+		const auto put32 = [&bytes](juce::uint32 value) {
+			value = juce::ByteOrder::swapIfBigEndian(value);
+			std::memcpy(bytes, &value, sizeof(value));
+			bytes += sizeof(value);
+		};
+		const auto put16 = [&bytes](juce::uint16 value) {
+			value = juce::ByteOrder::swapIfBigEndian(value);
+			std::memcpy(bytes, &value, sizeof(value));
+			bytes += sizeof(value);
+		};
+
+		put32(MAGIC);
+		put16(VERSION);
+		put16(static_cast<juce::uint16>(entries.size()));
+
+		for (const auto& entry : entries) {
+			const float value = entry.parameter->convertFrom0to1(entry.parameter->getValue());
+			juce::uint32 valueBits;
+			std::memcpy(&valueBits, &value, sizeof(value));
+
+			put32(entry.idHash);
+			put32(valueBits);
+		}
+	}
+
+	// Caller checks isBinaryState() first. Parameters missing from the chunk go back to their defaults.
+	inline bool read(const void* data, int sizeInBytes, const std::vector<Entry>& entries) {
+		const auto* bytes = static_cast<const char*>(data);
+		const int numStored = juce::ByteOrder::littleEndianShort(bytes + 6);
+
+		// Later versions may only append entries, so the count is all that needs checking
+		if (static_cast<size_t>(sizeInBytes) < HEADER_SIZE + ENTRY_SIZE * static_cast<size_t>(numStored)) return false;
+
+		for (const auto& entry : entries) {
+			float value = entry.parameter->convertFrom0to1(entry.parameter->getDefaultValue());
+
+			for (int storedIdx = 0; storedIdx < numStored; storedIdx++) {
+				const auto* stored = bytes + HEADER_SIZE + ENTRY_SIZE * static_cast<size_t>(storedIdx);
+				if (juce::ByteOrder::littleEndianInt(stored) != entry.idHash) continue;
+
+				const juce::uint32 valueBits = juce::ByteOrder::littleEndianInt(stored + 4);
+				std::memcpy(&value, &valueBits, sizeof(value));
+				break;
+			}
+
+			if (std::isfinite(value))
+				entry.parameter->setValueNotifyingHost(entry.parameter->convertTo0to1(value));
+		}
+		return true;
+	}
+}
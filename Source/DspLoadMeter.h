@@ -0,0 +1,250 @@
+/*
+  ==============================================================================
+
+	Per-block DSP load measurement and optional Chrome trace output.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+	Times every processed block with the high resolution counter and relates it to the block's
+	real-time budget (numSamples / sampleRate). The audio thread only reads the counter twice and
+	updates three atomics; readers get a rolling average, the peak since their last read and the
+	number of blocks that took longer than their budget.
+
+	Tracing is opt-in: while active, every block is also pushed into a preallocated single-producer
+	FIFO and a background thread appends it to a Chrome trace JSON file (chrome://tracing, Perfetto).
+	The same thread can also write the rolling stats to juce::Logger once per LOG_INTERVAL_MS, with
+	or without an editor. It keeps its own peak, so the log and the editor do not reset each other's.
+*/
+class DspLoadMeter : private juce::Thread {
+public:
+	struct Stats {
+		float averageLoad = 0.0f;	// 1.0 = the whole budget
+		float peakLoad = 0.0f;
+		juce::uint32 overBudgetBlocks = 0;
+	};
+
+	// Measures the enclosing scope as one block of numSamples
+	class ScopedMeasurement {
+	public:
+		ScopedMeasurement(DspLoadMeter& meterToUse, int numSamplesInBlock) noexcept
+			: meter(meterToUse), numSamples(numSamplesInBlock), startTicks(juce::Time::getHighResolutionTicks()) {}
+
+		~ScopedMeasurement() noexcept {
+			meter.addBlock(startTicks, juce::Time::getHighResolutionTicks() - startTicks, numSamples);
+		}
+
+	private:
+		DspLoadMeter& meter;
+		const int numSamples;
+		const juce::int64 startTicks;
+
+		JUCE_DECLARE_NON_COPYABLE(ScopedMeasurement)
+	};
+
+	DspLoadMeter() : juce::Thread("LPanner Load Meter") {
+		events.resize(FIFO_SIZE);
+	}
+
+	~DspLoadMeter() override {
+		logging = false;
+		stopTrace();
+	}
+
+	//==============================================================================
+	// Called from prepareToPlay, before the audio thread runs
+	void prepare(double newSampleRate) {
+		sampleRate = newSampleRate;
+		averageLoad = 0.0f;
+		peakLoad = 0.0f;
+		logPeakLoad = 0.0f;
+		overBudgetBlocks = 0;
+	}
+
+	// Any thread; the peak restarts from the next block
+	Stats getStats() {
+		Stats stats;
+		stats.averageLoad = averageLoad.load(std::memory_order_relaxed);
+		stats.peakLoad = peakLoad.exchange(0.0f, std::memory_order_relaxed);
+		stats.overBudgetBlocks = overBudgetBlocks.load(std::memory_order_relaxed);
+		return stats;
+	}
+
+	//==============================================================================
+	// Message thread. Overwrites the file; returns false if it cannot be opened.
+	bool startTrace(const juce::File& file) {
+		stopTrace();
+
+		auto stream = std::make_unique<juce::FileOutputStream>(file);
+		if (!stream->openedOk()) return false;
+
+		stopThread(TRACE_INTERVAL_MS * 10);
+		stream->setPosition(0);
+		stream->truncate();
+		traceStream = std::move(stream);
+		traceStartTicks = juce::Time::getHighResolutionTicks();
+
+		tracing = true;
+		updateThread();
+		return true;
+	}
+
+	void stopTrace() {
+		tracing = false;
+		stopThread(TRACE_INTERVAL_MS * 10);
+		traceStream.reset();
+		updateThread();
+	}
+
+	// Message thread. Log lines start with name, so instances can be told apart.
+	void startLog(const juce::String& name) {
+		if (logging) return;
+
+		// Published by the store to logging, so a running trace thread is left alone
+		logName = name;
+		logging = true;
+		updateThread();
+	}
+
+private:
+	//==============================================================================
+	static constexpr int FIFO_SIZE = 8192;
+	static constexpr int TRACE_INTERVAL_MS = 50;
+	static constexpr juce::uint32 LOG_INTERVAL_MS = 1000;
+	static constexpr double AVERAGING_TIME_SECS = 1.0;
+
+	struct TraceEvent {
+		juce::int64 startTicks = 0;
+		juce::int64 durationTicks = 0;
+		int numSamples = 0;
+		float load = 0.0f;
+	};
+
+	double sampleRate = 0.0;
+
+	// Audio thread writes, readers only load (and reset the peak)
+	std::atomic<float> averageLoad{ 0.0f };
+	std::atomic<float> peakLoad{ 0.0f };
+	std::atomic<float> logPeakLoad{ 0.0f };
+	std::atomic<juce::uint32> overBudgetBlocks{ 0 };
+
+	// Trace events, audio thread to trace thread
+	std::atomic<bool> tracing{ false };
+	juce::AbstractFifo fifo{ FIFO_SIZE };
+	std::vector<TraceEvent> events;
+
+	// Trace thread only, set up before it starts
+	std::unique_ptr<juce::FileOutputStream> traceStream;
+	juce::int64 traceStartTicks = 0;
+	bool firstEvent = true;
+
+	// Written once by startLog
+	std::atomic<bool> logging{ false };
+	juce::String logName;
+
+	void addBlock(juce::int64 startTicks, juce::int64 durationTicks, int numSamples) noexcept {
+		if (numSamples <= 0 || sampleRate <= 0.0) return;
+
+		const double budgetSecs = numSamples / sampleRate;
+		const float load = static_cast<float>(juce::Time::highResolutionTicksToSeconds(durationTicks) / budgetSecs);
+
+		// Time-based smoothing, so the average means the same for every block size
+		const float alpha = static_cast<float>(1.0 - std::exp(-budgetSecs / AVERAGING_TIME_SECS));
+		const float average = averageLoad.load(std::memory_order_relaxed);
+		averageLoad.store(average + alpha * (load - average), std::memory_order_relaxed);
+
+		if (load > peakLoad.load(std::memory_order_relaxed))
+			peakLoad.store(load, std::memory_order_relaxed);
+
+		if (load > logPeakLoad.load(std::memory_order_relaxed))
+			logPeakLoad.store(load, std::memory_order_relaxed);
+
+		if (load > 1.0f)
+			overBudgetBlocks.store(overBudgetBlocks.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+		// A full FIFO drops the event rather than waiting for the writer
+		if (tracing.load(std::memory_order_relaxed)) {
+			const auto scope = fifo.write(1);
+			if (scope.blockSize1 > 0) events[static_cast<size_t>(scope.startIndex1)] = { startTicks, durationTicks, numSamples, load };
+		}
+	}
+
+	//==============================================================================
+	// The thread runs while tracing or logging
+	void updateThread() {
+		if ((traceStream != nullptr || logging) && !isThreadRunning())
+			startThread(juce::Thread::Priority::low);
+	}
+
+	void run() override {
+		// Events left from an earlier trace belong to another file
+		if (traceStream != nullptr) {
+			fifo.read(fifo.getNumReady());
+			firstEvent = true;
+			traceStream->writeText("[\n", false, false, nullptr);
+		}
+
+		auto nextLogMs = juce::Time::getMillisecondCounter() + LOG_INTERVAL_MS;
+
+		while (!threadShouldExit()) {
+			wait(TRACE_INTERVAL_MS);
+
+			if (traceStream != nullptr)
+				writeEvents();
+
+			if (logging && static_cast<juce::int32>(juce::Time::getMillisecondCounter() - nextLogMs) >= 0) {
+				writeLog();
+				nextLogMs += LOG_INTERVAL_MS;
+			}
+		}
+
+		if (traceStream != nullptr) {
+			writeEvents();
+			traceStream->writeText("\n]\n", false, false, nullptr);
+			traceStream->flush();
+		}
+	}
+
+	void writeLog() {
+		const float average = averageLoad.load(std::memory_order_relaxed);
+		const float peak = logPeakLoad.exchange(0.0f, std::memory_order_relaxed);
+		const auto overBudget = static_cast<int>(overBudgetBlocks.load(std::memory_order_relaxed));
+
+		juce::Logger::writeToLog(logName + " DSP load: average " + juce::String(average * 100.0f, 2) + " %, peak "
+			+ juce::String(peak * 100.0f, 2) + " %, over budget " + juce::String(overBudget));
+	}
+
+	void writeEvents() {
+		const auto scope = fifo.read(fifo.getNumReady());
+		const auto toMicroseconds = [](juce::int64 ticks) { return juce::Time::highResolutionTicksToSeconds(ticks) * 1.0e6; };
+
+		const auto writeRange = [&](int start, int size) {
+			for (int eventIdx = start; eventIdx < start + size; eventIdx++) {
+				const auto& event = events[static_cast<size_t>(eventIdx)];
+
+				juce::String line;
+				line << (firstEvent ? "" : ",\n")
+					<< "{\"name\":\"processBlock\",\"ph\":\"X\",\"pid\":1,\"tid\":1"
+					<< ",\"ts\":" << juce::String(toMicroseconds(event.startTicks - traceStartTicks), 3)
+					<< ",\"dur\":" << juce::String(toMicroseconds(event.durationTicks), 3)
+					<< ",\"args\":{\"samples\":" << event.numSamples
+					<< ",\"load\":" << juce::String(event.load, 4) << "}}";
+
+				traceStream->writeText(line, false, false, nullptr);
+				firstEvent = false;
+			}
+		};
+
+		writeRange(scope.startIndex1, scope.blockSize1);
+		writeRange(scope.startIndex2, scope.blockSize2);
+	}
+
+	//==============================================================================
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DspLoadMeter)
+};
@@ -0,0 +1,245 @@
+/*
+  ==============================================================================
+
+	Fractional delay line for the mid signal of the modern algorithm.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "StereoMatrixKernel.h"
+
+enum class DelayInterpolation {
+	linear,
+	lagrange3rd,
+	thiran
+};
+
+//==============================================================================
+/**
+	Power-of-two ring buffer of the mid signal (L + R) / 2.
+
+	A whole chunk is written before it is read, and the first chunkSize + INTERPOLATION_TAPS
+	samples are mirrored past the end of the ring. A constant-delay read is then one contiguous
+	run of memory, which the linear and Lagrange interpolators process with SIMDRegister.
+*/
+template <typename T>
+class MidDelayLine {
+public:
+	//==============================================================================
+	void prepare(int maximumDelaySamples, int maximumChunkSize) {
+		// Room for the longest delay, the taps behind it and one chunk written ahead of the reads
+		const int size = juce::nextPowerOfTwo(maximumDelaySamples + INTERPOLATION_TAPS + maximumChunkSize + 1);
+		mask = size - 1;
+		guardSize = maximumChunkSize + INTERPOLATION_TAPS;
+		maxDelaySamples = maximumDelaySamples;
+
+		buffer.setSize(1, size + guardSize);
+		clear();
+	}
+
+	void release() {
+		buffer.setSize(0, 0);
+		mask = 0;
+		guardSize = 0;
+		maxDelaySamples = 0;
+	}
+
+	void clear() {
+		buffer.clear();
+		writePosition = 0;
+		thiranState = 0;
+	}
+
+	bool isPrepared() const { return buffer.getNumSamples() > 0; }
+	int getMaximumDelaySamples() const { return maxDelaySamples; }
+
+	// Oldest sample any interpolator can reach at the maximum delay
+	int getHistorySize() const { return maxDelaySamples + INTERPOLATION_TAPS; }
+
+	void setInterpolation(DelayInterpolation newInterpolation) {
+		if (interpolation != newInterpolation) thiranState = 0;
+		interpolation = newInterpolation;
+	}
+
+	DelayInterpolation getInterpolation() const { return interpolation; }
+
+	//==============================================================================
+	// Stores the mid signal of a chunk at the write position without advancing it
+	void write(const T* leftPtr, const T* rightPtr, int numSamples) {
+		auto* data = buffer.getWritePointer(0);
+		const int size = mask + 1;
+
+		for (int sampleIdx = 0; sampleIdx < numSamples; sampleIdx++) {
+			const int position = (writePosition + sampleIdx) & mask;
+			const T mid = (leftPtr[sampleIdx] + rightPtr[sampleIdx]) * static_cast<T>(0.5);
+
+			data[position] = mid;
+			if (position < guardSize) data[position + size] = mid;
+		}
+	}
+
+	void advance(int numSamples) {
+		writePosition = (writePosition + numSamples) & mask;
+	}
+
+	//==============================================================================
+	// Reads a chunk at one fractional delay (at least 1 sample)
+	void read(T* destPtr, T delaySamples, int numSamples) {
+		switch (interpolation) {
+		case DelayInterpolation::linear:
+			readLinear(destPtr, delaySamples, numSamples);
+			break;
+		case DelayInterpolation::lagrange3rd:
+			readLagrange(destPtr, delaySamples, numSamples);
+			break;
+		case DelayInterpolation::thiran:
+			readRamped<DelayInterpolation::thiran>(destPtr, [delaySamples](int) { return delaySamples; }, numSamples);
+			break;
+		}
+	}
+
+	// Reads a chunk at a per-sample fractional delay
+	void read(T* destPtr, const T* delaySamples, int numSamples) {
+		const auto delayAt = [delaySamples](int sampleIdx) { return delaySamples[sampleIdx]; };
+
+		switch (interpolation) {
+		case DelayInterpolation::linear:
+			readRamped<DelayInterpolation::linear>(destPtr, delayAt, numSamples);
+			break;
+		case DelayInterpolation::lagrange3rd:
+			readRamped<DelayInterpolation::lagrange3rd>(destPtr, delayAt, numSamples);
+			break;
+		case DelayInterpolation::thiran:
+			readRamped<DelayInterpolation::thiran>(destPtr, delayAt, numSamples);
+			break;
+		}
+	}
+
+private:
+	//==============================================================================
+	static constexpr int INTERPOLATION_TAPS = 3;
+
+	using Vec = StereoMatrixKernel::Vec<T>;
+
+	juce::AudioBuffer<T> buffer;
+	int mask = 0;
+	int guardSize = 0;
+	int maxDelaySamples = 0;
+	int writePosition = 0;
+
+	DelayInterpolation interpolation = DelayInterpolation::linear;
+	T thiranState = 0;
+
+	//==============================================================================
+	// Oldest sample of a contiguous run, which the mirrored guard keeps from wrapping
+	const T* getRun(int delayInt) const {
+		return buffer.getReadPointer(0) + ((writePosition - delayInt) & mask);
+	}
+
+	void readLinear(T* destPtr, T delaySamples, int numSamples) const {
+		const int delayInt = static_cast<int>(delaySamples);
+		const T delayFrac = delaySamples - static_cast<T>(delayInt);
+
+		// run[i + 1] is delayed by delayInt, run[i] by delayInt + 1
+		const T* run = getRun(delayInt + 1);
+
+		constexpr int width = static_cast<int>(Vec::size());
+		const Vec frac = Vec::expand(delayFrac);
+		int sampleIdx = 0;
+
+		for (; sampleIdx + width <= numSamples; sampleIdx += width) {
+			const auto value1 = StereoMatrixKernel::load(run + sampleIdx + 1);
+			const auto value2 = StereoMatrixKernel::load(run + sampleIdx);
+			StereoMatrixKernel::store(destPtr + sampleIdx, value1 + frac * (value2 - value1));
+		}
+
+		for (; sampleIdx < numSamples; sampleIdx++)
+			destPtr[sampleIdx] = run[sampleIdx + 1] + delayFrac * (run[sampleIdx] - run[sampleIdx + 1]);
+	}
+
+	void readLagrange(T* destPtr, T delaySamples, int numSamples) const {
+		int delayInt = static_cast<int>(delaySamples);
+		T delayFrac = delaySamples - static_cast<T>(delayInt);
+
+		// Center the fractional part between the middle taps
+		if (delayInt >= 1) {
+			delayFrac++;
+			delayInt--;
+		}
+
+		const T d1 = delayFrac - 1, d2 = delayFrac - 2, d3 = delayFrac - 3;
+		const T c1 = -d1 * d2 * d3 / 6, c2 = d2 * d3 * static_cast<T>(0.5), c3 = -d1 * d3 * static_cast<T>(0.5), c4 = d1 * d2 / 6;
+
+		// run[i + 3] is delayed by delayInt, run[i] by delayInt + 3
+		const T* run = getRun(delayInt + 3);
+
+		constexpr int width = static_cast<int>(Vec::size());
+		int sampleIdx = 0;
+
+		for (; sampleIdx + width <= numSamples; sampleIdx += width) {
+			const auto value1 = StereoMatrixKernel::load(run + sampleIdx + 3);
+			const auto value2 = StereoMatrixKernel::load(run + sampleIdx + 2);
+			const auto value3 = StereoMatrixKernel::load(run + sampleIdx + 1);
+			const auto value4 = StereoMatrixKernel::load(run + sampleIdx);
+			StereoMatrixKernel::store(destPtr + sampleIdx, value1 * c1 + (value2 * c2 + value3 * c3 + value4 * c4) * delayFrac);
+		}
+
+		for (; sampleIdx < numSamples; sampleIdx++)
+			destPtr[sampleIdx] = run[sampleIdx + 3] * c1 + delayFrac * (run[sampleIdx + 2] * c2 + run[sampleIdx + 1] * c3 + run[sampleIdx] * c4);
+	}
+
+	// Per-sample interpolation for moving delays and the recursive Thiran allpass
+	template <DelayInterpolation type, typename DelayAt>
+	void readRamped(T* destPtr, DelayAt delayAt, int numSamples) {
+		const auto* data = buffer.getReadPointer(0);
+
+		for (int sampleIdx = 0; sampleIdx < numSamples; sampleIdx++) {
+			const T delaySamples = delayAt(sampleIdx);
+			int delayInt = static_cast<int>(delaySamples);
+			T delayFrac = delaySamples - static_cast<T>(delayInt);
+			const int position = writePosition + sampleIdx;
+
+			if constexpr (type == DelayInterpolation::linear) {
+				const T value1 = data[(position - delayInt) & mask];
+				const T value2 = data[(position - delayInt - 1) & mask];
+				destPtr[sampleIdx] = value1 + delayFrac * (value2 - value1);
+			}
+			else if constexpr (type == DelayInterpolation::lagrange3rd) {
+				if (delayInt >= 1) {
+					delayFrac++;
+					delayInt--;
+				}
+
+				const T value1 = data[(position - delayInt) & mask];
+				const T value2 = data[(position - delayInt - 1) & mask];
+				const T value3 = data[(position - delayInt - 2) & mask];
+				const T value4 = data[(position - delayInt - 3) & mask];
+
+				const T d1 = delayFrac - 1, d2 = delayFrac - 2, d3 = delayFrac - 3;
+				const T c1 = -d1 * d2 * d3 / 6, c2 = d2 * d3 * static_cast<T>(0.5), c3 = -d1 * d3 * static_cast<T>(0.5), c4 = d1 * d2 / 6;
+
+				destPtr[sampleIdx] = value1 * c1 + delayFrac * (value2 * c2 + value3 * c3 + value4 * c4);
+			}
+			else {
+				// Keep the allpass coefficient away from its unstable region
+				if (delayFrac < static_cast<T>(0.618) && delayInt >= 1) {
+					delayFrac++;
+					delayInt--;
+				}
+
+				const T value1 = data[(position - delayInt) & mask];
+				const T value2 = data[(position - delayInt - 1) & mask];
+				const T alpha = (1 - delayFrac) / (1 + delayFrac);
+
+				thiranState = delayFrac == 0 ? value1 : value2 + alpha * (value1 - thiranState);
+				destPtr[sampleIdx] = thiranState;
+			}
+		}
+	}
+
+	//==============================================================================
+	JUCE_LEAK_DETECTOR(MidDelayLine)
+};
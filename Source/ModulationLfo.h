@@ -0,0 +1,115 @@
+/*
+  ==============================================================================
+
+	Control-rate LFO for automatic rotation and width movement.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+enum class LfoShape {
+	sine,
+	triangle,
+	sampleAndHold
+};
+
+//==============================================================================
+/**
+	Phase accumulator evaluated once per control interval, not per sample: advance() moves the
+	phase over a whole interval and returns the value at its end, which the processor hands to
+	the parameter smoothers as their next target. The smoothers then interpolate linearly between
+	control points, so modulation costs one shape evaluation per interval.
+
+	In sync mode the rate follows the host tempo, and while the host is playing the phase is
+	locked to its beat position at the start of every block, so the LFO stays on the grid after
+	loops and relocations.
+*/
+class ModulationLfo {
+public:
+	// Note lengths of the lfoSyncRate choices, in quarter notes per cycle
+	static constexpr double SYNC_BEATS[] = { 16.0, 8.0, 4.0, 2.0, 1.0, 0.5, 0.25 };
+	static constexpr int NUM_SYNC_RATES = static_cast<int>(std::size(SYNC_BEATS));
+
+	void prepare(double newSampleRate) {
+		sampleRate = newSampleRate;
+		reset();
+	}
+
+	void reset() {
+		random.setSeed(RANDOM_SEED);
+		phase = 0.0;
+		shapePhase = 0.0;
+		heldValue = nextRandomValue();
+	}
+
+	//==============================================================================
+	// Once per block, before the first advance()
+	void setShape(LfoShape newShape, float phaseOffsetDegrees) {
+		shape = newShape;
+		phaseOffset = phaseOffsetDegrees / 360.0;
+	}
+
+	void setRateHz(double rateHz) {
+		increment = rateHz / sampleRate;
+	}
+
+	// hostBeatPosition is the host's position in quarter notes, when it is playing and reports one
+	void setTempoSync(double bpm, int syncRateIndex, std::optional<double> hostBeatPosition) {
+		const double beatsPerCycle = SYNC_BEATS[juce::jlimit(0, NUM_SYNC_RATES - 1, syncRateIndex)];
+		increment = bpm / (60.0 * beatsPerCycle * sampleRate);
+
+		if (hostBeatPosition.has_value()) {
+			const double cycles = *hostBeatPosition / beatsPerCycle;
+			phase = cycles - std::floor(cycles);
+		}
+	}
+
+	//==============================================================================
+	// Moves the phase by numSamples and returns the value at the new position, in [-1, 1]
+	float advance(int numSamples) {
+		phase += increment * numSamples;
+		phase -= std::floor(phase);
+
+		const double newShapePhase = wrap(phase + phaseOffset);
+
+		// A new step whenever the shape's cycle restarts, including a jump back after a relocation
+		if (newShapePhase < shapePhase)
+			heldValue = nextRandomValue();
+		shapePhase = newShapePhase;
+
+		switch (shape) {
+		case LfoShape::sine:
+			return static_cast<float>(std::sin(juce::MathConstants<double>::twoPi * shapePhase));
+		case LfoShape::triangle:
+			// Same zero crossings and peaks as the sine
+			return static_cast<float>(1.0 - 4.0 * std::abs(wrap(shapePhase + 0.25) - 0.5));
+		case LfoShape::sampleAndHold:
+		default:
+			return heldValue;
+		}
+	}
+
+private:
+	double sampleRate = 44100.0;
+	double increment = 0.0;
+	double phase = 0.0;
+	double phaseOffset = 0.0;
+	double shapePhase = 0.0;
+	LfoShape shape = LfoShape::sine;
+
+	// Reseeded on reset, so offline renders are repeatable
+	static constexpr juce::int64 RANDOM_SEED = 0x4c50;
+	juce::Random random{ RANDOM_SEED };
+	float heldValue = 0.0f;
+
+	static double wrap(double value) {
+		return value - std::floor(value);
+	}
+
+	float nextRandomValue() {
+		return random.nextFloat() * 2.0f - 1.0f;
+	}
+};
@@ -0,0 +1,131 @@
+/*
+  ==============================================================================
+
+	Lightweight editor built from native JUCE components.
+
+  ==============================================================================
+*/
+
+#include "NativeEditor.h"
+
+//==============================================================================
+LPannerNativeEditor::LPannerNativeEditor(LPannerAudioProcessor& p)
+	: AudioProcessorEditor(&p), audioProcessor(p)
+{
+	auto& parameters = audioProcessor.parameters;
+
+	// Set per component, the default LookAndFeel is shared with the host and other plugins
+	for (auto* slider : { &delaySlider, &spectralLowWidthSlider, &stereoSlider, &rotationSlider }) {
+		slider->setColour(juce::Slider::thumbColourId, accentColour);
+		slider->setColour(juce::Slider::trackColourId, primaryColour);
+		slider->setColour(juce::Slider::backgroundColourId, secondaryColour);
+		slider->setColour(juce::Slider::rotarySliderFillColourId, primaryColour);
+		slider->setColour(juce::Slider::rotarySliderOutlineColourId, secondaryColour);
+		slider->setColour(juce::Slider::textBoxTextColourId, primaryColour);
+	}
+	for (auto* label : { &titleLabel, &loadLabel, &stereoModeLabel, &delayLabel, &stereoLabel, &rotationLabel })
+		label->setColour(juce::Label::textColourId, primaryColour);
+	bypassButton.setColour(juce::ToggleButton::textColourId, primaryColour);
+	bypassButton.setColour(juce::ToggleButton::tickColourId, accentColour);
+
+	titleLabel.setText(juce::String(ProjectInfo::projectName) + " " + ProjectInfo::versionString, juce::dontSendNotification);
+	titleLabel.setFont(juce::FontOptions(20.0f, juce::Font::bold));
+	loadLabel.setJustificationType(juce::Justification::centredRight);
+
+	const auto setUpLabel = [this](juce::Label& label, const juce::String& text) {
+		label.setText(text, juce::dontSendNotification);
+		label.setJustificationType(juce::Justification::centred);
+		addAndMakeVisible(label);
+	};
+	setUpLabel(stereoModeLabel, "mode");
+	setUpLabel(delayLabel, "delay");
+	setUpLabel(stereoLabel, "stereo");
+	setUpLabel(rotationLabel, "rotation");
+
+	// Items must exist before the attachment maps the parameter onto them
+	stereoModeBox.addItemList({ "Classic", "Modern", "Spectral" }, 1);
+	stereoModeBox.onChange = [this] { updateModeControls(); };
+
+	for (auto* component : std::initializer_list<juce::Component*>{ &titleLabel, &loadLabel, &bypassButton, &stereoModeBox,
+		&delaySlider, &spectralLowWidthSlider, &stereoSlider, &rotationSlider })
+		addAndMakeVisible(component);
+
+	stereoModeAttachment = std::make_unique<ComboBoxAttachment>(parameters, "stereoMode", stereoModeBox);
+	delayAttachment = std::make_unique<SliderAttachment>(parameters, "delay", delaySlider);
+	spectralLowWidthAttachment = std::make_unique<SliderAttachment>(parameters, "spectralLowWidth", spectralLowWidthSlider);
+	stereoAttachment = std::make_unique<SliderAttachment>(parameters, "stereo", stereoSlider);
+	rotationAttachment = std::make_unique<SliderAttachment>(parameters, "rotation", rotationSlider);
+	bypassAttachment = std::make_unique<ButtonAttachment>(parameters, "bypass", bypassButton);
+
+	updateModeControls();
+	setSize(480, 280);
+
+	timerCallback();
+	startTimerHz(LOAD_REFRESH_RATE);
+}
+
+LPannerNativeEditor::~LPannerNativeEditor()
+{
+	stopTimer();
+}
+
+//==============================================================================
+void LPannerNativeEditor::paint(juce::Graphics& g)
+{
+	g.fillAll(backgroundColour);
+}
+
+void LPannerNativeEditor::resized()
+{
+	constexpr int margin = 16;
+	constexpr int rowHeight = 32;
+	constexpr int labelWidth = 72;
+
+	auto bounds = getLocalBounds().reduced(margin);
+
+	auto header = bounds.removeFromTop(rowHeight);
+	bypassButton.setBounds(header.removeFromRight(90));
+	loadLabel.setBounds(header.removeFromRight(140));
+	titleLabel.setBounds(header);
+
+	bounds.removeFromTop(margin);
+
+	// Mode switch with the delay (or low width) knob next to it, as in the WebView layout
+	auto modeRow = bounds.removeFromTop(bounds.getHeight() - 2 * rowHeight - margin);
+	auto knobArea = modeRow.removeFromRight(modeRow.getWidth() / 2);
+	delayLabel.setBounds(knobArea.removeFromTop(20));
+	delaySlider.setBounds(knobArea);
+	spectralLowWidthSlider.setBounds(knobArea);
+
+	stereoModeLabel.setBounds(modeRow.removeFromTop(20));
+	stereoModeBox.setBounds(modeRow.withSizeKeepingCentre(juce::jmin(160, modeRow.getWidth()), rowHeight));
+
+	bounds.removeFromTop(margin);
+
+	auto stereoRow = bounds.removeFromTop(rowHeight);
+	stereoLabel.setBounds(stereoRow.removeFromLeft(labelWidth));
+	stereoSlider.setBounds(stereoRow);
+
+	auto rotationRow = bounds.removeFromTop(rowHeight);
+	rotationLabel.setBounds(rotationRow.removeFromLeft(labelWidth));
+	rotationSlider.setBounds(rotationRow);
+}
+
+void LPannerNativeEditor::timerCallback() {
+	const auto stats = audioProcessor.getLoadMeter().getStats();
+
+	loadLabel.setText("DSP " + juce::String(stats.averageLoad * 100.0f, 1) + " % / peak " + juce::String(stats.peakLoad * 100.0f, 1) + " %",
+		juce::dontSendNotification);
+	loadLabel.setColour(juce::Label::textColourId, stats.peakLoad > 1.0f ? accentColour : primaryColour);
+}
+
+// Spectral mode swaps the delay knob for the low width knob; delay only applies to modern
+void LPannerNativeEditor::updateModeControls() {
+	const auto mode = stereoModeBox.getSelectedItemIndex();
+	const bool spectral = mode == 2;
+
+	delaySlider.setVisible(!spectral);
+	delaySlider.setEnabled(mode == 1);
+	spectralLowWidthSlider.setVisible(spectral);
+	delayLabel.setText(spectral ? "low" : "delay", juce::dontSendNotification);
+}
@@ -0,0 +1,75 @@
+/*
+  ==============================================================================
+
+	Lightweight editor built from native JUCE components.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+
+//==============================================================================
+/**
+	Same controls as the WebView editor, bound to the same parameters through the stock APVTS
+	attachments. It owns no browser process and no analysis thread, so it opens instantly and
+	costs little memory per instance: meant for large sessions and hosts without a WebView.
+*/
+class LPannerNativeEditor : public juce::AudioProcessorEditor, private juce::Timer
+{
+public:
+	LPannerNativeEditor(LPannerAudioProcessor&);
+	~LPannerNativeEditor() override;
+
+	//==============================================================================
+	void paint(juce::Graphics&) override;
+	void resized() override;
+
+private:
+	LPannerAudioProcessor& audioProcessor;
+
+	// The DSP load readout is the only live display
+	static constexpr int LOAD_REFRESH_RATE = 4;
+
+	void timerCallback() override;
+	void updateModeControls();
+
+	//==============================================================================
+	// Colours of the WebView theme
+	const juce::Colour backgroundColour{ 0xff9c7474 };
+	const juce::Colour primaryColour{ 0xff3e3737 };
+	const juce::Colour secondaryColour{ 0xff575252 };
+	const juce::Colour accentColour{ 0xff9c3e3e };
+
+	juce::Label titleLabel;
+	juce::Label loadLabel;
+	juce::ToggleButton bypassButton{ "bypass" };
+
+	juce::ComboBox stereoModeBox;
+	juce::Slider delaySlider{ juce::Slider::RotaryHorizontalVerticalDrag, juce::Slider::TextBoxBelow };
+	juce::Slider spectralLowWidthSlider{ juce::Slider::RotaryHorizontalVerticalDrag, juce::Slider::TextBoxBelow };
+	juce::Slider stereoSlider{ juce::Slider::LinearHorizontal, juce::Slider::TextBoxRight };
+	juce::Slider rotationSlider{ juce::Slider::LinearHorizontal, juce::Slider::TextBoxRight };
+
+	juce::Label stereoModeLabel;
+	juce::Label delayLabel;
+	juce::Label stereoLabel;
+	juce::Label rotationLabel;
+
+	//==============================================================================
+	// Declared after the controls, so they are destroyed first
+	using SliderAttachment = juce::AudioProcessorValueTreeState::SliderAttachment;
+	using ComboBoxAttachment = juce::AudioProcessorValueTreeState::ComboBoxAttachment;
+	using ButtonAttachment = juce::AudioProcessorValueTreeState::ButtonAttachment;
+
+	std::unique_ptr<ComboBoxAttachment> stereoModeAttachment;
+	std::unique_ptr<SliderAttachment> delayAttachment;
+	std::unique_ptr<SliderAttachment> spectralLowWidthAttachment;
+	std::unique_ptr<SliderAttachment> stereoAttachment;
+	std::unique_ptr<SliderAttachment> rotationAttachment;
+	std::unique_ptr<ButtonAttachment> bypassAttachment;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LPannerNativeEditor)
+};
@@ -9,6 +9,8 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
 
+#if LPANNER_WEB_EDITOR
+
 //==============================================================================
 LPannerAudioProcessorEditor::LPannerAudioProcessorEditor(LPannerAudioProcessor& p)
 	: AudioProcessorEditor(&p), audioProcessor(p)
@@ -20,10 +22,15 @@ LPannerAudioProcessorEditor::LPannerAudioProcessorEditor(LPannerAudioProcessor&
 	webComponent.goToURL(juce::WebBrowserComponent::getResourceProviderRoot());
 
 	setSize(800, 500);
+
+	audioProcessor.getAnalyser().start();
+	startTimerHz(EDITOR_FRAME_RATE);
 }
 
 LPannerAudioProcessorEditor::~LPannerAudioProcessorEditor()
 {
+	stopTimer();
+	audioProcessor.getAnalyser().stop();
 }
 
 //==============================================================================
@@ -40,49 +47,103 @@ void LPannerAudioProcessorEditor::resized()
 	webComponent.setBounds(getLocalBounds());
 }
 
-std::optional<juce::WebBrowserComponent::Resource> LPannerAudioProcessorEditor::getResource(const juce::String& url) {
-	const auto urlToRetrive = url == "/" ? juce::String{ "index.html" } : url.fromFirstOccurrenceOf("/", false, false);
+void LPannerAudioProcessorEditor::timerCallback() {
+	// While hidden the bridge keeps collecting, and the first visible frame sends the latest values
+	if (!webComponent.isShowing()) return;
 
-	static auto streamZip = juce::MemoryInputStream(juce::MemoryBlock(BinaryData::assets_zip, BinaryData::assets_zipSize), true);
+	sendParameters();
 
-	static juce::ZipFile archive{ streamZip };
+	if (++timerTicks % ANALYSIS_EVENT_INTERVAL == 0)
+		sendAnalysis();
 
-	if (auto* entry = archive.getEntry(urlToRetrive)) {
-		auto entryStream = rawToUniquePtr(archive.createStreamForEntry(*entry));
-		std::vector<std::byte> result((size_t)entryStream->getTotalLength());
-		entryStream->setPosition(0);
-		entryStream->read(result.data(), result.size());
+	if (timerTicks % LOAD_EVENT_INTERVAL == 0)
+		sendLoad();
+}
 
-		auto mime = getMimeForExtension(entry->filename.fromLastOccurrenceOf(".", false, false).toLowerCase());
+void LPannerAudioProcessorEditor::sendParameters() {
+	const auto changes = parameterBridge.collectChanges();
+	if (changes.isVoid()) return;
 
-		return juce::WebBrowserComponent::Resource{ std::move(result), std::move(mime) };
-	}
-	return std::nullopt;
+	webComponent.emitEventIfBrowserIsVisible("parameters", changes);
+}
+
+void LPannerAudioProcessorEditor::sendAnalysis() {
+	if (!audioProcessor.getAnalyser().getSnapshot(analysisSnapshot, analysisSnapshot.sequence)) return;
+
+	// The point cloud goes over as a base64 Float32Array, so the page decodes it without parsing numbers
+	auto* analysis = new juce::DynamicObject();
+	analysis->setProperty("correlation", analysisSnapshot.correlation);
+	analysis->setProperty("balance", analysisSnapshot.balance);
+	analysis->setProperty("points", juce::Base64::toBase64(analysisSnapshot.points.data(), analysisSnapshot.points.size() * sizeof(float)));
+
+	webComponent.emitEventIfBrowserIsVisible("analysis", juce::var(analysis));
+}
+
+void LPannerAudioProcessorEditor::sendLoad() {
+	const auto stats = audioProcessor.getLoadMeter().getStats();
+
+	auto* load = new juce::DynamicObject();
+	load->setProperty("average", stats.averageLoad);
+	load->setProperty("peak", stats.peakLoad);
+	load->setProperty("overBudget", static_cast<int>(stats.overBudgetBlocks));
+
+	webComponent.emitEventIfBrowserIsVisible("dspLoad", juce::var(load));
 }
 
-const char* LPannerAudioProcessorEditor::getMimeForExtension(const juce::String& extension) {
-	static const std::unordered_map<juce::String, const char*> mimeMap = {
-		{{"htm"}, "text/html"},
-		{{"html"}, "text/html"},
-		{{"txt"}, "text/plane"},
-		{{"css"}, "text/css"},
-		{{"js"}, "application/javascript"},
-		{{"json"}, "application/json"},
-		{{"map"}, "application/json"},
-		{{"png"}, "image/png"},
-		{{"jpg"}, "image/jpeg"},
-		{{"jpeg"}, "image/jpeg"},
-		{{"ico"}, "image/vnd.microsoft.icon"},
-		{{"gif"}, "image/gif"},
-		{{"svg"}, "image/svg+xml"},
-		{{"woff"}, "font/woff"},
-		{{"woff2"}, "font/woff2"}
-	};
-
-	if (const auto it = mimeMap.find(extension.toLowerCase());
-		it != mimeMap.end())
-		return it->second;
-
-	jassertfalse;
-	return "";
-}
\ No newline at end of file
+juce::WebBrowserComponent::Options LPannerAudioProcessorEditor::createBrowserOptions() {
+	return juce::WebBrowserComponent::Options{}
+#if JUCE_WINDOWS
+		.withBackend(juce::WebBrowserComponent::Options::Backend::webview2)
+		.withWinWebView2Options(
+			juce::WebBrowserComponent::Options::WinWebView2{}
+				.withUserDataFolder(juce::File::getSpecialLocation(
+					juce::File::SpecialLocationType::tempDirectory)))
+#endif
+		.withOptionsFrom(controlParameterIndexReceiver)
+		.withNativeFunction("getParameterInfo",
+			[this](auto&, auto complete) {
+				complete(parameterBridge.getParameterInfo());
+			})
+		.withEventListener("setParameter",
+			[this](const auto& payload) { parameterBridge.handleSetParameter(payload); })
+		.withEventListener("parameterGesture",
+			[this](const auto& payload) { parameterBridge.handleGesture(payload); })
+		.withNativeFunction("getPluginInfo",
+			[this](auto&, auto complete) {
+				complete(pluginInfo);
+			})
+		.withNativeFunction("pressSpaceKey",
+			[this](auto& var, auto complete) {
+				DBG("pressSpaceKey");
+#if JUCE_WINDOWS
+				// get window handle
+				auto hwnd = webComponent.getWindowHandle();
+
+				// setfocus
+				SetFocus(static_cast<HWND>(hwnd));
+
+				INPUT input;
+				input.type = INPUT_KEYBOARD;
+				input.ki.wVk = VK_SPACE;
+				SendInput(1, &input, sizeof(INPUT));
+				input.ki.dwFlags = KEYEVENTF_KEYUP;
+				SendInput(1, &input, sizeof(INPUT));
+#endif
+				// Other backends pass the key on to the host themselves; the page still gets its reply
+				complete({});
+			})
+		.withResourceProvider(
+			[this](const auto& url) { return getResource(url); },
+			juce::URL{"http://localhost:5173/"}.getOrigin());
+}
+
+std::optional<juce::WebBrowserComponent::Resource> LPannerAudioProcessorEditor::getResource(const juce::String& url) {
+	const auto urlToRetrive = url == "/" ? juce::String{ "index.html" } : url.fromFirstOccurrenceOf("/", false, false);
+
+	// Resource owns its bytes, so serving is one copy out of the shared, already inflated cache
+	if (const auto* asset = webAssets->find(urlToRetrive))
+		return juce::WebBrowserComponent::Resource{ asset->data, asset->mimeType };
+
+	return std::nullopt;
+}
+#endif
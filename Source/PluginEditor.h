@@ -10,8 +10,15 @@
 
 #include <JuceHeader.h>
 #include "PluginProcessor.h"
+#include "NativeEditor.h"
+
+#if LPANNER_WEB_EDITOR
+#include "WebAssetCache.h"
+#include "WebParameterBridge.h"
+#if JUCE_WINDOWS
 #define NOMINMAX
 #include "Windows.h"
+#endif
 
 struct SinglePageBrowser : juce::WebBrowserComponent {
 	using WebBrowserComponent::WebBrowserComponent;
@@ -25,7 +32,7 @@ struct SinglePageBrowser : juce::WebBrowserComponent {
 //==============================================================================
 /**
 */
-class LPannerAudioProcessorEditor : public juce::AudioProcessorEditor
+class LPannerAudioProcessorEditor : public juce::AudioProcessorEditor, private juce::Timer
 {
 public:
 	LPannerAudioProcessorEditor(LPannerAudioProcessor&);
@@ -45,14 +52,27 @@ private:
 	// access the processor object that created it.
 	LPannerAudioProcessor& audioProcessor;
 
+	// Parameter changes go to the page once per frame; nothing is sent while the editor is hidden
+	static constexpr int EDITOR_FRAME_RATE = 60;
+
+	// Upper bound for analysis events; the timer only sends when the analyser published something new
+	static constexpr int ANALYSIS_EVENT_INTERVAL = 2;
+	StereoAnalysisSnapshot analysisSnapshot;
+
+	// DSP load goes to the page a few times per second; the processor logs it on its own
+	static constexpr int LOAD_EVENT_INTERVAL = EDITOR_FRAME_RATE / 4;
+	int timerTicks = 0;
+
+	void timerCallback() override;
+	void sendParameters();
+	void sendAnalysis();
+	void sendLoad();
+
 	//==============================================================================
 	juce::WebControlParameterIndexReceiver controlParameterIndexReceiver;
 
-	juce::WebSliderRelay stereoRelay{ "stereo" };
-	juce::WebComboBoxRelay stereoModeRelay{ "stereoMode" };
-	juce::WebSliderRelay delayRelay{ "delay" };
-	juce::WebSliderRelay rotationRelay{ "rotation" };
-	juce::WebToggleButtonRelay bypassRelay{ "bypass" };
+	WebParameterBridge parameterBridge{ audioProcessor.parameters,
+		{ "stereo", "stereoMode", "delay", "rotation", "bypass", "spectralLowWidth" } };
 
 	//==============================================================================
 	juce::var pluginInfo = [this]() {
@@ -65,57 +85,15 @@ private:
 		return juce::var(obj);
 	}();
 
-	SinglePageBrowser webComponent{
-		juce::WebBrowserComponent::Options{}
-			.withBackend(juce::WebBrowserComponent::Options::Backend::webview2)
-			.withWinWebView2Options(
-				juce::WebBrowserComponent::Options::WinWebView2{}
-					.withUserDataFolder(juce::File::getSpecialLocation(
-						juce::File::SpecialLocationType::tempDirectory)))
-			.withOptionsFrom(stereoRelay)
-			.withOptionsFrom(stereoModeRelay)
-			.withOptionsFrom(delayRelay)
-			.withOptionsFrom(rotationRelay)
-			.withOptionsFrom(bypassRelay)
-			.withOptionsFrom(controlParameterIndexReceiver)
-			.withNativeFunction("getPluginInfo",
-				[this](auto&, auto complete) {
-					complete(pluginInfo);
-				})
-			.withNativeFunction("pressSpaceKey",
-				[this](auto& var, auto complete) {
-					DBG("pressSpaceKey");
-					// get window handle
-					auto hwnd = webComponent.getWindowHandle();
-
-					// setfocus
-					SetFocus(static_cast<HWND>(hwnd));
-
-					INPUT input;
-					input.type = INPUT_KEYBOARD;
-					input.ki.wVk = VK_SPACE;
-					SendInput(1, &input, sizeof(INPUT));
-					input.ki.dwFlags = KEYEVENTF_KEYUP;
-					SendInput(1, &input, sizeof(INPUT));
-
-					complete({});
-				})
-			.withResourceProvider(
-				[this](const auto& url) { return getResource(url); },
-				juce::URL{"http://localhost:5173/"}.getOrigin()) 
-	};
+	// Inflated assets, shared with every other editor and kept alive by the processors
+	juce::SharedResourcePointer<WebAssetCache> webAssets;
 
-	std::optional<juce::WebBrowserComponent::Resource> getResource(const juce::String& url);
-
-	const char* getMimeForExtension(const juce::String& extension);
+	SinglePageBrowser webComponent{ createBrowserOptions() };
 
-	//==============================================================================
+	juce::WebBrowserComponent::Options createBrowserOptions();
+	std::optional<juce::WebBrowserComponent::Resource> getResource(const juce::String& url);
 
-	juce::WebSliderParameterAttachment stereoAttachment{ *audioProcessor.parameters.getParameter("stereo"), stereoRelay, nullptr };
-	juce::WebComboBoxParameterAttachment stereoModeAttachment{ *audioProcessor.parameters.getParameter("stereoMode"), stereoModeRelay, nullptr };
-	juce::WebSliderParameterAttachment delayAttachment{ *audioProcessor.parameters.getParameter("delay"), delayRelay, nullptr };
-	juce::WebSliderParameterAttachment rotationAttachment{ *audioProcessor.parameters.getParameter("rotation"), rotationRelay, nullptr };
-	juce::WebToggleButtonParameterAttachment bypassAttachment{ *audioProcessor.parameters.getParameter("bypass"), bypassRelay, nullptr };
 
 	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LPannerAudioProcessorEditor)
 };
+#endif
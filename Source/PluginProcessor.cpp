@@ -7,7 +7,12 @@
 */
 
 #include "PluginProcessor.h"
+#include "RealtimeSafety.h"
+
+// Headless builds (benchmarks and command-line tools) leave out the editors
+#if ! LPANNER_HEADLESS
 #include "PluginEditor.h"
+#endif
 
 //==============================================================================
 LPannerAudioProcessor::LPannerAudioProcessor()
@@ -22,10 +27,41 @@ LPannerAudioProcessor::LPannerAudioProcessor()
 	)
 #endif
 {
+	for (auto* parameter : getParameters()) {
+		auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter);
+		jassert(ranged != nullptr);
+		stateEntries.push_back({ BinaryState::hashParameterID(ranged->getParameterID()), ranged });
+	}
+
+	// Two IDs with the same hash would share one value in saved states
+	for (size_t entryIdx = 0; entryIdx < stateEntries.size(); entryIdx++)
+		for (size_t otherIdx = entryIdx + 1; otherIdx < stateEntries.size(); otherIdx++)
+			jassert(stateEntries[entryIdx].idHash != stateEntries[otherIdx].idHash);
+
+	// Opt-in block trace for offline profiling, written on the meter's own thread (one file per instance)
+	const auto traceDirectory = juce::SystemStats::getEnvironmentVariable("LPANNER_TRACE_DIR", {});
+	if (traceDirectory.isNotEmpty() && juce::File::isAbsolutePath(traceDirectory) && juce::File(traceDirectory).createDirectory())
+		loadMeter.startTrace(juce::File(traceDirectory).getNonexistentChildFile("LPanner-trace", ".json", false));
+
+	// Rolling DSP load once per second, always in debug builds and opt-in in release builds
+#if JUCE_DEBUG
+	loadMeter.startLog("LPanner");
+#else
+	if (juce::SystemStats::getEnvironmentVariable("LPANNER_LOAD_LOG", {}).isNotEmpty())
+		loadMeter.startLog("LPanner");
+#endif
+
+	parameters.addParameterListener("stereoMode", this);
+	parameters.addParameterListener("bassMono", this);
+	parameters.addParameterListener("bassMonoFreq", this);
 }
 
 LPannerAudioProcessor::~LPannerAudioProcessor()
 {
+	parameters.removeParameterListener("stereoMode", this);
+	parameters.removeParameterListener("bassMono", this);
+	parameters.removeParameterListener("bassMonoFreq", this);
+	cancelPendingUpdate();
 }
 
 //==============================================================================
@@ -63,7 +99,9 @@ bool LPannerAudioProcessor::isMidiEffect() const
 
 double LPannerAudioProcessor::getTailLengthSeconds() const
 {
-	return 0.0;
+	// Ringing after the reported latency: the longest delay, the crossover's decay or the last STFT frame
+	const double sampleRate = getSampleRate();
+	return sampleRate > 0.0 ? tailSamples.load() / sampleRate : 0.0;
 }
 
 int LPannerAudioProcessor::getNumPrograms()
@@ -92,15 +130,14 @@ void LPannerAudioProcessor::changeProgramName(int index, const juce::String& new
 
 //==============================================================================
 void LPannerAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock) {
-	juce::ignoreUnused(samplesPerBlock);
-
 	double smoothingTimeSecs = SMOOTHING_TIME_MS * 0.001f;
 
 	stereoSmoothed.reset(sampleRate, smoothingTimeSecs);
 	stereoSmoothed.setCurrentAndTargetValue(*stereo);
 
 	stereoModeSmoothed.reset(sampleRate, smoothingTimeSecs);
-	stereoModeSmoothed.setCurrentAndTargetValue(*stereoMode);
+	// Same 0/1 classic/modern weight as setTargetValue; the raw choice index can be 2 (spectral)
+	stereoModeSmoothed.setCurrentAndTargetValue((!static_cast<int>(*stereoMode) || *stereo < 100.0f) ? 0.0f : 1.0f);
 
 	delaySmoothed.reset(sampleRate, smoothingTimeSecs);
 	delaySmoothed.setCurrentAndTargetValue(*delay);
@@ -111,21 +148,133 @@ void LPannerAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock
 	dryWetSmoothed.reset(sampleRate, smoothingTimeSecs);
 	dryWetSmoothed.setCurrentAndTargetValue(*bypass ? 0.0f : 1.0f);
 
-	updateDelayBufferSize(sampleRate);
-	writePosition = 0;
+	pitchSmoothed.reset(sampleRate, smoothingTimeSecs);
+	pitchSmoothed.setCurrentAndTargetValue(*pitch);
+
+	rollSmoothed.reset(sampleRate, smoothingTimeSecs);
+	rollSmoothed.setCurrentAndTargetValue(*roll);
+
+	// The LFO sets a new smoother target whenever the previous ramp has finished, so the interval
+	// is the smoothers' own step count
+	lfo.prepare(sampleRate);
+	modulationInterval = juce::jmax(1, static_cast<int>(std::floor(sampleRate * smoothingTimeSecs)));
+	samplesToControlPoint = 0;
+
+	// Delay times are stepped from milliseconds with one multiply instead of querying the sample rate per sample
+	delayMsToSamples = sampleRate * 0.001;
+
+	updateChannelPairs();
+	updateBufferSizes(sampleRate, juce::jmax(1, samplesPerBlock));
+
+	// The STFT latency depends on the sample rate; it is only reported while the spectral mode is selected
+	spectralLatency = 1 << SpectralWidthEngine<float>::getFFTOrderForSampleRate(sampleRate);
+	spectralMatrix.prepare(sampleRate, spectralLatency);
+	spectralActive = !ambisonicBus && static_cast<int>(*stereoMode) == spectralChoice;
+	setLatencySamples(getTargetLatency());
+	updateTailLength();
+
+	ambisonicRotator.reset(getAmbisonicMatrix());
+
+	analyser.prepare(sampleRate);
+	loadMeter.prepare(sampleRate);
+	silentSamples = 0;
 }
 
 void LPannerAudioProcessor::releaseResources() {
-	delayBufferF.setSize(0, 0);
-	delayBufferD.setSize(0, 0);
+	coefficientRampsF.setSize(0, 0);
+	coefficientRampsD.setSize(0, 0);
+	scratchBufferF.setSize(0, 0);
+	scratchBufferD.setSize(0, 0);
+	delayLinesF.clear();
+	delayLinesD.clear();
+	crossoversF.clear();
+	crossoversD.clear();
+	spectralEnginesF.clear();
+	spectralEnginesD.clear();
 }
 
-void LPannerAudioProcessor::updateDelayBufferSize(double sampleRate) {
-	const int delayBufferSize = static_cast<int>(sampleRate * DELAY_SECS);
-	delayBufferF.setSize(1, delayBufferSize);
-	delayBufferD.setSize(1, delayBufferSize);
-	delayBufferF.clear();
-	delayBufferD.clear();
+void LPannerAudioProcessor::updateChannelPairs() {
+	const auto layout = getBusesLayout().getMainOutputChannelSet();
+	channelPairs.clear();
+	passThroughChannels.clear();
+
+	// An ambisonic bus is rotated as a whole and has no pairs
+	ambisonicBus = layout == juce::AudioChannelSet::ambisonic(1);
+	if (ambisonicBus) return;
+
+	// A mono bus is processed as a dual-mono pair and folded back down
+	if (layout.size() == 1) {
+		channelPairs.push_back({ 0, -1 });
+		return;
+	}
+
+	// Centre and LFE have no partner and pass through untouched
+	const auto addPair = [this, &layout](juce::AudioChannelSet::ChannelType left, juce::AudioChannelSet::ChannelType right) {
+		const int leftIdx = layout.getChannelIndexForType(left);
+		const int rightIdx = layout.getChannelIndexForType(right);
+		if (leftIdx >= 0 && rightIdx >= 0) channelPairs.push_back({ leftIdx, rightIdx });
+	};
+
+	addPair(juce::AudioChannelSet::left, juce::AudioChannelSet::right);
+	addPair(juce::AudioChannelSet::leftSurround, juce::AudioChannelSet::rightSurround);
+	addPair(juce::AudioChannelSet::leftSurroundSide, juce::AudioChannelSet::rightSurroundSide);
+	addPair(juce::AudioChannelSet::leftSurroundRear, juce::AudioChannelSet::rightSurroundRear);
+
+	for (int channel = 0; channel < layout.size(); channel++) {
+		const bool paired = std::any_of(channelPairs.begin(), channelPairs.end(),
+			[channel](const ChannelPair& pair) { return pair.left == channel || pair.right == channel; });
+		if (!paired) passThroughChannels.push_back(channel);
+	}
+}
+
+void LPannerAudioProcessor::updateBufferSizes(double sampleRate, int chunkSize) {
+	const auto maxDelaySamples = static_cast<int>(std::ceil(parameters.getParameterRange("delay").end * sampleRate * 0.001));
+
+	const auto numPairs = channelPairs.size();
+
+	// Both precisions share the FFT size, and with it the latency
+	const juce::dsp::ProcessSpec compensationSpec{ sampleRate, static_cast<juce::uint32>(chunkSize), static_cast<juce::uint32>(juce::jmax<size_t>(1, passThroughChannels.size())) };
+	const int compensationSamples = 1 << SpectralWidthEngine<float>::getFFTOrderForSampleRate(sampleRate);
+
+	// Only allocate the precision the host is going to process in
+	if (isUsingDoublePrecision()) {
+		coefficientRampsD.setSize(numRampChannels, chunkSize);
+		coefficientRampsF.setSize(0, 0);
+		delayLinesD.resize(numPairs);
+		for (auto& delayLine : delayLinesD) delayLine.prepare(maxDelaySamples, chunkSize);
+		delayLinesF.clear();
+		delayHistorySamples = numPairs > 0 ? delayLinesD.front().getHistorySize() : 0;
+		crossoversD.resize(numPairs);
+		for (auto& crossover : crossoversD) crossover.prepare(sampleRate);
+		crossoversF.clear();
+		spectralEnginesD.resize(numPairs);
+		for (auto& engine : spectralEnginesD) engine.prepare(sampleRate);
+		spectralEnginesF.clear();
+		latencyCompensationD.setMaximumDelayInSamples(compensationSamples);
+		latencyCompensationD.prepare(compensationSpec);
+		latencyCompensationD.setDelay(static_cast<double>(compensationSamples));
+		scratchBufferD.setSize(numScratchChannels, chunkSize);
+		scratchBufferF.setSize(0, 0);
+	}
+	else {
+		coefficientRampsF.setSize(numRampChannels, chunkSize);
+		coefficientRampsD.setSize(0, 0);
+		delayLinesF.resize(numPairs);
+		for (auto& delayLine : delayLinesF) delayLine.prepare(maxDelaySamples, chunkSize);
+		delayLinesD.clear();
+		delayHistorySamples = numPairs > 0 ? delayLinesF.front().getHistorySize() : 0;
+		crossoversF.resize(numPairs);
+		for (auto& crossover : crossoversF) crossover.prepare(sampleRate);
+		crossoversD.clear();
+		spectralEnginesF.resize(numPairs);
+		for (auto& engine : spectralEnginesF) engine.prepare(sampleRate);
+		spectralEnginesD.clear();
+		latencyCompensationF.setMaximumDelayInSamples(compensationSamples);
+		latencyCompensationF.prepare(compensationSpec);
+		latencyCompensationF.setDelay(static_cast<float>(compensationSamples));
+		scratchBufferF.setSize(numScratchChannels, chunkSize);
+		scratchBufferD.setSize(0, 0);
+	}
 }
 
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -135,17 +284,25 @@ bool LPannerAudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts) c
 	juce::ignoreUnused(layouts);
 	return true;
 #else
-	// This is the place where you check if the layout is supported.
-	// In this template code we only support mono or stereo.
+	// Mono, stereo and the 5.1/7.1 stem layouts, whose L/R pairs share one set of coefficients,
+	// and first-order ambisonics (ACN/SN3D), whose soundfield is rotated instead.
 	// Some plugin hosts, such as certain GarageBand versions, will only
 	// load plugins that support stereo bus layouts.
-	if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-		&& layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+	const auto mainOutput = layouts.getMainOutputChannelSet();
+
+	if (mainOutput != juce::AudioChannelSet::mono()
+		&& mainOutput != juce::AudioChannelSet::stereo()
+		&& mainOutput != juce::AudioChannelSet::create5point1()
+		&& mainOutput != juce::AudioChannelSet::create7point1()
+		&& mainOutput != juce::AudioChannelSet::ambisonic(1))
 		return false;
 
-	// This checks if the input layout matches the output layout
+	// This checks if the input layout matches the output layout, apart from mono to stereo
 #if ! JucePlugin_IsSynth
-	if (layouts.getMainOutputChannelSet() != layouts.getMainInputChannelSet())
+	const auto mainInput = layouts.getMainInputChannelSet();
+
+	if (mainOutput != mainInput
+		&& !(mainInput == juce::AudioChannelSet::mono() && mainOutput == juce::AudioChannelSet::stereo()))
 		return false;
 #endif
 
@@ -157,16 +314,20 @@ bool LPannerAudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts) c
 //==============================================================================
 void LPannerAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) {
 	processBlockImpl(buffer, midiMessages);
+	pushAnalysis(buffer);
 }
 
 void LPannerAudioProcessor::processBlock(juce::AudioBuffer<double>& buffer, juce::MidiBuffer& midiMessages) {
 	processBlockImpl(buffer, midiMessages);
+	pushAnalysis(buffer);
 }
 
 template <typename T>
 void LPannerAudioProcessor::processBlockImpl(juce::AudioBuffer<T>& buffer, juce::MidiBuffer& midiMessages) {
 	juce::ignoreUnused(midiMessages);
 	juce::ScopedNoDenormals noDenormals;
+	LPANNER_REALTIME_SCOPE;
+	const DspLoadMeter::ScopedMeasurement loadMeasurement(loadMeter, buffer.getNumSamples());
 
 	const auto totalNumInputChannels = getTotalNumInputChannels();
 	const auto totalNumOutputChannels = getTotalNumOutputChannels();
@@ -176,78 +337,592 @@ void LPannerAudioProcessor::processBlockImpl(juce::AudioBuffer<T>& buffer, juce:
 	for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
 		buffer.clear(i, 0, buffer.getNumSamples());
 
-	auto& delayBuffer = getDelayBuffer<T>();
-	const auto delayBufferSize = delayBuffer.getNumSamples();
+	// Hosts may send blocks larger than announced in prepareToPlay, so work in ramp-sized chunks
+	// prepareToPlay only allocates the buffers for the precision reported by isUsingDoublePrecision()
+	const auto rampSize = getCoefficientRamps<T>().getNumSamples();
+	auto& delayLines = getDelayLines<T>();
+	const bool layoutPrepared = ambisonicBus || (!delayLines.empty() && delayLines.size() == channelPairs.size());
+	jassert(rampSize > 0 && layoutPrepared);
+	if (rampSize == 0 || !layoutPrepared) return;
+
+	// Mono in, stereo out: widen a copy of the single input channel
+	if (totalNumInputChannels == 1 && totalNumOutputChannels > 1)
+		buffer.copyFrom(1, 0, buffer, 0, 0, bufferSize);
+
+	updateProcessingQuality();
+	const bool modulating = updateModulation();
+	setTargetValue(modulating);
+
+	// The STFT path has its own latency, so a switch into or out of it is a hard cut: every processing
+	// path starts from silence. The new latency is reported from the message thread (parameterChanged).
+	const bool spectral = !ambisonicBus && static_cast<int>(*stereoMode) == spectralChoice;
+	if (spectral != spectralActive) {
+		spectralActive = spectral;
+		resetProcessingState<T>();
+		stereoModeSmoothed.setCurrentAndTargetValue(stereoModeSmoothed.getTargetValue());
+	}
+
+	// Silent input with every delay, filter and frame decayed: the input already is the output.
+	// The first block with signal resets the count and is processed in full.
+	if (isSilent(buffer)) {
+		const bool decayed = silentSamples >= getRingSamples() + (spectralActive ? spectralLatency : 0);
+		silentSamples += bufferSize;
+
+		if (decayed) {
+			skipSilentBlock(bufferSize, modulating);
+			return;
+		}
+	}
+	else {
+		silentSamples = 0;
+	}
+
+	// Bypass is the wet ramp of the rotation matrix, which ends on the identity
+	if (ambisonicBus) {
+		processAmbisonic(buffer, modulating);
+		return;
+	}
+
+	// Bypass stays inside the spectral path, so the output keeps the latency the host compensates for
+	if (spectral) {
+		processSpectral(buffer, modulating);
+		return;
+	}
+
+	// The crossover follows its parameters once per block; while off it is kept cleared for a clean start
+	auto& crossovers = getCrossovers<T>();
+	const bool bassMonoEnabled = *bassMono >= 0.5f;
+	const auto slope = static_cast<int>(*bassMonoSlope) == 0 ? CrossoverSlope::lr2 : CrossoverSlope::lr4;
+
+	for (auto& crossover : crossovers) {
+		if (bassMonoEnabled) crossover.setParameters(*bassMonoFreq, slope);
+		else crossover.reset();
+	}
+
+	// True bypass once the dry ramp has finished: the input passes through untouched
+	if (!dryWetSmoothed.isSmoothing() && dryWetSmoothed.getTargetValue() <= 0.0f) {
+		processBypassed(buffer, bassMonoEnabled);
+		return;
+	}
+
+	auto* monoRightPtr = getScratchBuffer<T>().getWritePointer(monoRightScratch);
+
+	// While the LFO runs, chunks are also cut at its control points, which carry over between blocks
+	for (int startSample = 0, numSamples = 0; startSample < bufferSize; startSample += numSamples) {
+		numSamples = juce::jmin(rampSize, bufferSize - startSample);
+
+		if (modulating)
+			numSamples = applyModulation(numSamples);
 
-	auto* leftPtr = buffer.getWritePointer(0);
-	auto* rightPtr = buffer.getWritePointer(1);
+		// Pick the kernel before the smoothers advance through the chunk
+		const auto mode = selectKernelMode();
+		const bool smoothing = isSmoothing();
+		ProcessingState<T> state;
 
-	setTargetValue();
+		// One coefficient pass per chunk, shared by every channel pair
+		updateChunkCoefficients(state, smoothing, numSamples);
 
-	ProcessingState state;
+		for (size_t pairIdx = 0; pairIdx < channelPairs.size(); pairIdx++) {
+			const auto& pair = channelPairs[pairIdx];
+			const bool dualMono = pair.right < 0;
 
-	for (int sampleIdx = 0; sampleIdx < bufferSize; sampleIdx++) {
-		updateParameterValues(state);
+			auto* leftPtr = buffer.getWritePointer(pair.left, startSample);
+			auto* rightPtr = dualMono ? monoRightPtr : buffer.getWritePointer(pair.right, startSample);
+			auto* crossover = bassMonoEnabled ? &crossovers[pairIdx] : nullptr;
 
-		// Skip for-loop if completely dry
-		if (state.wetMix <= 0.0f) {
-			incrementWritePosition(delayBufferSize);
+			if (dualMono)
+				juce::FloatVectorOperations::copy(rightPtr, leftPtr, numSamples);
+
+			if (smoothing) {
+				// Every pair reads the same per-sample coefficients through the ramped kernel
+				processRamped(leftPtr, rightPtr, numSamples, mode, delayLines[pairIdx], crossover);
+			}
+			else {
+				// Every knob is at rest, so the coefficients are constant for the whole chunk
+				processStatic(leftPtr, rightPtr, numSamples, state, mode, delayLines[pairIdx], crossover);
+			}
+
+			// Fold the processed pair back down to what a mono listener hears
+			if (dualMono) {
+				juce::FloatVectorOperations::add(leftPtr, rightPtr, numSamples);
+				juce::FloatVectorOperations::multiply(leftPtr, static_cast<T>(0.5), numSamples);
+			}
+		}
+	}
+}
+
+// Without the crossover the whole chunk goes into the delay line before the kernel reads the delayed
+// mid back. With it, the kernel pulls the bands and the delayed mid of each vector just before mixing
+// them, so crossover, delay line and matrix share one pass over the chunk.
+// readDelay(dest, sampleIdx, numSamples) reads the delayed mid of that run of the chunk.
+template <typename T, typename Coefficients, typename ReadDelay>
+void LPannerAudioProcessor::processPair(T* leftPtr, T* rightPtr, int numSamples, StereoMatrixKernel::Mode mode, MidDelayLine<T>& delayLine, BassMonoCrossover<T>* crossover, const Coefficients& coefficients, ReadDelay&& readDelay) {
+	// Classic mode still writes, so a later switch to modern starts from real history
+	const bool readsDelay = mode != StereoMatrixKernel::Mode::classic;
+
+	if (crossover == nullptr) {
+		auto* midDelayPtr = getScratchBuffer<T>().getWritePointer(midDelayScratch);
+
+		// Store the whole chunk first; the delay is at least 1 ms, so every read below sees the same history as a per-sample loop
+		delayLine.write(leftPtr, rightPtr, numSamples);
+		if (readsDelay)
+			readDelay(midDelayPtr, 0, numSamples);
+
+		StereoMatrixKernel::process(mode, leftPtr, rightPtr, midDelayPtr, numSamples, coefficients);
+		delayLine.advance(numSamples);
+		return;
+	}
+
+	// Only the high bands are widened, so only their mid goes into the delay line
+	const auto bandSource = [&](int sampleIdx, int runSize, StereoMatrixKernel::SplitBands<T>& bands) {
+		crossover->process(leftPtr + sampleIdx, rightPtr + sampleIdx, bands.highLeft, bands.highRight, bands.low, runSize);
+		delayLine.write(bands.highLeft, bands.highRight, runSize);
+		if (readsDelay)
+			readDelay(bands.midDelay, sampleIdx, runSize);
+		delayLine.advance(runSize);
+	};
+
+	StereoMatrixKernel::processSplit(mode, leftPtr, rightPtr, bandSource, numSamples, coefficients);
+}
+
+template <typename T>
+void LPannerAudioProcessor::processStatic(T* leftPtr, T* rightPtr, int numSamples, const ProcessingState<T>& state, StereoMatrixKernel::Mode mode, MidDelayLine<T>& delayLine, BassMonoCrossover<T>* crossover) {
+	StereoMatrixKernel::StaticCoefficients<T> coefficients{ {
+		state.leftClassicCoefficient1,
+		state.leftClassicCoefficient2,
+		state.rightClassicCoefficient1,
+		state.rightClassicCoefficient2,
+		state.cosTheta,
+		state.sinTheta,
+		state.leftModernCoefficient,
+		state.rightModernCoefficient,
+		state.wetMix,
+		state.stereoMix,
+	} };
+
+	// Constant delay makes the delayed mid one contiguous, vectorized interpolation
+	processPair(leftPtr, rightPtr, numSamples, mode, delayLine, crossover, coefficients,
+		[&delayLine, &state](T* destPtr, int, int runSize) { delayLine.read(destPtr, state.delaySamples, runSize); });
+}
+
+template <typename T>
+void LPannerAudioProcessor::processRamped(T* leftPtr, T* rightPtr, int numSamples, StereoMatrixKernel::Mode mode, MidDelayLine<T>& delayLine, BassMonoCrossover<T>* crossover) {
+	const auto& coefficientRamps = getCoefficientRamps<T>();
+
+	StereoMatrixKernel::RampedCoefficients<T> coefficients{ {
+		coefficientRamps.getReadPointer(leftClassicCoefficient1Ramp),
+		coefficientRamps.getReadPointer(leftClassicCoefficient2Ramp),
+		coefficientRamps.getReadPointer(rightClassicCoefficient1Ramp),
+		coefficientRamps.getReadPointer(rightClassicCoefficient2Ramp),
+		coefficientRamps.getReadPointer(cosThetaRamp),
+		coefficientRamps.getReadPointer(sinThetaRamp),
+		coefficientRamps.getReadPointer(leftModernCoefficientRamp),
+		coefficientRamps.getReadPointer(rightModernCoefficientRamp),
+		coefficientRamps.getReadPointer(wetMixRamp),
+		coefficientRamps.getReadPointer(stereoMixRamp),
+	} };
+
+	// Interpolate the delayed mid signal at the per-sample delay
+	const auto* delayRamp = coefficientRamps.getReadPointer(delaySamplesRamp);
+	processPair(leftPtr, rightPtr, numSamples, mode, delayLine, crossover, coefficients,
+		[&delayLine, delayRamp](T* destPtr, int sampleIdx, int runSize) { delayLine.read(destPtr, delayRamp + sampleIdx, runSize); });
+}
+
+template <typename T>
+void LPannerAudioProcessor::processBypassed(const juce::AudioBuffer<T>& buffer, bool bassMonoEnabled) {
+	auto& delayLines = getDelayLines<T>();
+	auto& crossovers = getCrossovers<T>();
+	const int numSamples = buffer.getNumSamples();
+
+	// Keep only the history a delayed read can reach after re-engaging, so the wet ramp starts from real audio.
+	// With bass mono the delay line holds the high bands only, so the history goes through the crossover too,
+	// which also leaves the crossover settled on the input when the wet ramp starts.
+	for (size_t pairIdx = 0; pairIdx < channelPairs.size(); pairIdx++) {
+		const auto& pair = channelPairs[pairIdx];
+		auto& delayLine = delayLines[pairIdx];
+		const int historySize = juce::jmin(numSamples, delayLine.getHistorySize());
+		const int startSample = numSamples - historySize;
+
+		const auto* leftPtr = buffer.getReadPointer(pair.left, startSample);
+		const auto* rightPtr = pair.right < 0 ? leftPtr : buffer.getReadPointer(pair.right, startSample);
+
+		delayLine.advance(startSample);
+
+		if (!bassMonoEnabled) {
+			delayLine.write(leftPtr, rightPtr, historySize);
+			delayLine.advance(historySize);
 			continue;
 		}
 
-		// Calculate read position for delay
-		const int readPosition = calculateReadPosition(state.delaySamples, delayBufferSize);
+		auto& crossover = crossovers[pairIdx];
+		StereoMatrixKernel::SplitBands<T> bands;
+		crossover.reset();
+
+		for (int sampleIdx = 0; sampleIdx < historySize; sampleIdx += bands.size) {
+			const int runSize = juce::jmin(bands.size, historySize - sampleIdx);
+			crossover.process(leftPtr + sampleIdx, rightPtr + sampleIdx, bands.highLeft, bands.highRight, bands.low, runSize);
+			delayLine.write(bands.highLeft, bands.highRight, runSize);
+			delayLine.advance(runSize);
+		}
+	}
+
+	// Follow the knobs without ramping, so re-engaging only ramps the wet mix
+	stereoSmoothed.setCurrentAndTargetValue(stereoSmoothed.getTargetValue());
+	stereoModeSmoothed.setCurrentAndTargetValue(stereoModeSmoothed.getTargetValue());
+	delaySmoothed.setCurrentAndTargetValue(delaySmoothed.getTargetValue());
+	rotationSmoothed.setCurrentAndTargetValue(rotationSmoothed.getTargetValue());
+}
+
+template <typename T>
+void LPannerAudioProcessor::processSpectral(juce::AudioBuffer<T>& buffer, bool modulating) {
+	auto& engines = getSpectralEngines<T>();
+	auto& latencyCompensation = getLatencyCompensation<T>();
+	auto* monoRightPtr = getScratchBuffer<T>().getWritePointer(monoRightScratch);
+	const int scratchSize = getScratchBuffer<T>().getNumSamples();
+	const int bufferSize = buffer.getNumSamples();
+
+	for (int startSample = 0, numSamples = 0; startSample < bufferSize; startSample += numSamples) {
+		numSamples = juce::jmin(scratchSize, bufferSize - startSample);
+
+		if (modulating)
+			numSamples = applyModulation(numSamples);
+
+		// The bin matrix changes once per hop at most and overlap-add crossfades between frames,
+		// so the smoothers are followed at chunk rate
+		stereoSmoothed.skip(numSamples);
+		stereoModeSmoothed.skip(numSamples);
+		delaySmoothed.skip(numSamples);
+		rotationSmoothed.skip(numSamples);
+		dryWetSmoothed.skip(numSamples);
+
+		spectralMatrix.update(*spectralLowWidth * 0.01f,
+			stereoSmoothed.getCurrentValue() * 0.01f,
+			juce::degreesToRadians(rotationSmoothed.getCurrentValue()),
+			dryWetSmoothed.getCurrentValue(),
+			*bassMono >= 0.5f ? bassMonoFreq->load() : 0.0f);
+
+		for (size_t pairIdx = 0; pairIdx < channelPairs.size(); pairIdx++) {
+			const auto& pair = channelPairs[pairIdx];
+			const bool dualMono = pair.right < 0;
+
+			auto* leftPtr = buffer.getWritePointer(pair.left, startSample);
+			auto* rightPtr = dualMono ? monoRightPtr : buffer.getWritePointer(pair.right, startSample);
+
+			if (dualMono)
+				juce::FloatVectorOperations::copy(rightPtr, leftPtr, numSamples);
+
+			engines[pairIdx].process(leftPtr, rightPtr, numSamples, spectralMatrix);
+
+			if (dualMono) {
+				juce::FloatVectorOperations::add(leftPtr, rightPtr, numSamples);
+				juce::FloatVectorOperations::multiply(leftPtr, static_cast<T>(0.5), numSamples);
+			}
+		}
+
+		for (size_t compensationIdx = 0; compensationIdx < passThroughChannels.size(); compensationIdx++) {
+			auto* channelPtr = buffer.getWritePointer(passThroughChannels[compensationIdx], startSample);
+			const auto delayChannel = static_cast<int>(compensationIdx);
 
-		// Store current input values
-		const T leftInput = leftPtr[sampleIdx];
-		const T rightInput = rightPtr[sampleIdx];
+			for (int sampleIdx = 0; sampleIdx < numSamples; sampleIdx++) {
+				latencyCompensation.pushSample(delayChannel, channelPtr[sampleIdx]);
+				channelPtr[sampleIdx] = latencyCompensation.popSample(delayChannel);
+			}
+		}
+	}
+}
 
-		// Calculate mid signal and store in delayBuffer
-		const T midInput = (leftInput + rightInput) * static_cast<T>(0.5);
-		delayBuffer.setSample(0, writePosition, midInput);
+template <typename T>
+void LPannerAudioProcessor::processAmbisonic(juce::AudioBuffer<T>& buffer, bool modulating) {
+	auto* const* channels = buffer.getArrayOfWritePointers();
+	const int bufferSize = buffer.getNumSamples();
 
-		// Get delayed mid signal from delayBuffer
-		auto midDelaySignal = delayBuffer.getSample(0, readPosition);
+	for (int startSample = 0, numSamples = 0; startSample < bufferSize; startSample += numSamples) {
+		numSamples = bufferSize - startSample;
 
-		// Calcurate outputs
-		auto leftClassic = state.leftClassicCoefficient1 * leftInput + state.leftClassicCoefficient2 * rightInput;
-		auto rightClassic = state.rightClassicCoefficient1 * leftInput + state.rightClassicCoefficient2 * rightInput;
-		auto leftModern = leftInput * state.cosTheta - rightInput * state.sinTheta + state.leftModernCoefficient * midDelaySignal;
-		auto rightModern = leftInput * state.sinTheta + rightInput * state.cosTheta + state.rightModernCoefficient * midDelaySignal;
+		if (modulating)
+			numSamples = applyModulation(numSamples);
 
-		// Mixdown outputs
-		auto leftOutput = (1 - state.wetMix) * leftInput + state.wetMix * ((1 - state.stereoMix) * leftClassic + state.stereoMix * leftModern);
-		auto rightOutput = (1 - state.wetMix) * rightInput + state.wetMix * ((1 - state.stereoMix) * rightClassic + state.stereoMix * rightModern);
+		// At rest one matrix covers the chunk; while an angle moves the chunk is cut at the control interval
+		for (int controlStart = 0; controlStart < numSamples;) {
+			const bool moving = isAmbisonicSmoothing();
+			const int numControlSamples = moving ? juce::jmin(AMBISONIC_CONTROL_INTERVAL, numSamples - controlStart) : numSamples - controlStart;
 
-		// Write outputs to buffer
-		leftPtr[sampleIdx] = leftOutput;
-		rightPtr[sampleIdx] = rightOutput;
+			if (moving) {
+				rotationSmoothed.skip(numControlSamples);
+				pitchSmoothed.skip(numControlSamples);
+				rollSmoothed.skip(numControlSamples);
+				dryWetSmoothed.skip(numControlSamples);
+			}
 
-		// Increment write position
-		incrementWritePosition(delayBufferSize);
+			ambisonicRotator.process(channels, startSample + controlStart, numControlSamples, getAmbisonicMatrix());
+			controlStart += numControlSamples;
+		}
 	}
+
+	// Width, mode and delay have no meaning for the soundfield
+	stereoSmoothed.setCurrentAndTargetValue(stereoSmoothed.getTargetValue());
+	stereoModeSmoothed.setCurrentAndTargetValue(stereoModeSmoothed.getTargetValue());
+	delaySmoothed.setCurrentAndTargetValue(delaySmoothed.getTargetValue());
 }
 
-void LPannerAudioProcessor::setTargetValue() {
-	stereoSmoothed.setTargetValue(*stereo);
+template <typename T>
+bool LPannerAudioProcessor::isSilent(const juce::AudioBuffer<T>& buffer) const {
+	const auto threshold = static_cast<T>(SILENCE_THRESHOLD);
+
+	for (int channel = 0; channel < getTotalNumOutputChannels(); channel++) {
+		const auto range = juce::FloatVectorOperations::findMinAndMax(buffer.getReadPointer(channel), buffer.getNumSamples());
+		if (range.getStart() < -threshold || range.getEnd() > threshold) return false;
+	}
+	return true;
+}
+
+template <typename T>
+void LPannerAudioProcessor::resetProcessingState() {
+	for (auto& delayLine : getDelayLines<T>()) delayLine.clear();
+	for (auto& crossover : getCrossovers<T>()) crossover.reset();
+	for (auto& engine : getSpectralEngines<T>()) engine.reset();
+	getLatencyCompensation<T>().reset();
+}
+
+template <typename T>
+void LPannerAudioProcessor::pushAnalysis(const juce::AudioBuffer<T>& buffer) {
+	// Only the main pair is metered; a mono bus shows up as a centred line
+	if (channelPairs.empty()) return;
+
+	const auto& pair = channelPairs.front();
+	const auto* leftPtr = buffer.getReadPointer(pair.left);
+	const auto* rightPtr = pair.right < 0 ? leftPtr : buffer.getReadPointer(pair.right);
+	analyser.push(leftPtr, rightPtr, buffer.getNumSamples());
+}
+
+// While modulating, rotation and width targets belong to the LFO's control points
+void LPannerAudioProcessor::setTargetValue(bool modulating) {
+	if (!modulating) {
+		stereoSmoothed.setTargetValue(*stereo);
+		rotationSmoothed.setTargetValue(*rotation);
+	}
+
 	stereoModeSmoothed.setTargetValue((!static_cast<int>(*stereoMode) || *stereo < 100.0f) ? 0.0f : 1.0f);
 	delaySmoothed.setTargetValue(*delay);
-	rotationSmoothed.setTargetValue(*rotation);
 	dryWetSmoothed.setTargetValue(*bypass ? 0.0f : 1.0f);
+	pitchSmoothed.setTargetValue(*pitch);
+	rollSmoothed.setTargetValue(*roll);
+}
+
+// Follows the LFO parameters and the host tempo once per block; returns whether any depth is set
+bool LPannerAudioProcessor::updateModulation() {
+	// Switching back on starts with a fresh control point
+	if (*lfoDepth <= 0.0f && *lfoWidthDepth <= 0.0f) {
+		samplesToControlPoint = 0;
+		return false;
+	}
+
+	lfo.setShape(static_cast<LfoShape>(static_cast<int>(*lfoShape)), *lfoPhase);
+
+	if (*lfoSync < 0.5f) {
+		lfo.setRateHz(*lfoRate);
+		return true;
+	}
+
+	// Without a tempo the LFO runs at the default one; the phase is only locked while the host plays
+	double bpm = DEFAULT_TEMPO_BPM;
+	std::optional<double> beatPosition;
+
+	if (auto* playHead = getPlayHead()) {
+		if (const auto position = playHead->getPosition()) {
+			if (const auto hostBpm = position->getBpm()) bpm = *hostBpm;
+			if (const auto ppq = position->getPpqPosition(); ppq && position->getIsPlaying()) beatPosition = *ppq;
+		}
+	}
+
+	// Between control points the LFO's phase is that of the pending control point, not of the block start
+	if (beatPosition.has_value())
+		*beatPosition += samplesToControlPoint * bpm / (60.0 * getSampleRate());
+
+	lfo.setTempoSync(bpm, static_cast<int>(*lfoSyncRate), beatPosition);
+	return true;
+}
+
+// Returns the length of the next chunk: at most maxSamples, and never past the next control point.
+// At a control point the LFO moves one interval ahead and its value there becomes the smoothers'
+// target, which their ramp reaches exactly at the following control point, whatever the block size.
+// The knobs stay the centre of the movement and the parameters themselves never change, so the
+// host sees no automation. The classic/modern choice keeps following the stereo knob, so a width
+// sweep across 100 % does not crossfade modes.
+int LPannerAudioProcessor::applyModulation(int maxSamples) {
+	if (samplesToControlPoint == 0) {
+		const float value = lfo.advance(modulationInterval);
+
+		// Both stay inside their parameter ranges, whatever the knob and depth
+		rotationSmoothed.setTargetValue(juce::jlimit(-50.0f, 50.0f, *rotation + *lfoDepth * value));
+		stereoSmoothed.setTargetValue(juce::jlimit(0.0f, 200.0f, *stereo + *lfoWidthDepth * value));
+		samplesToControlPoint = modulationInterval;
+	}
+
+	const int numSamples = juce::jmin(maxSamples, samplesToControlPoint);
+	samplesToControlPoint -= numSamples;
+	return numSamples;
+}
+
+// Called on whichever thread changed the parameter; only the message thread reports latency and tail
+void LPannerAudioProcessor::parameterChanged(const juce::String& parameterID, float newValue) {
+	juce::ignoreUnused(parameterID, newValue);
+	triggerAsyncUpdate();
+}
+
+void LPannerAudioProcessor::handleAsyncUpdate() {
+	const int latency = getTargetLatency();
+	if (latency != getLatencySamples())
+		setLatencySamples(latency);
+
+	if (updateTailLength())
+		updateHostDisplay();
+}
+
+int LPannerAudioProcessor::getTargetLatency() const {
+	return !ambisonicBus && static_cast<int>(*stereoMode) == spectralChoice ? spectralLatency : 0;
+}
+
+// Samples from the last non-silent input until the output has decayed, not counting the reported latency
+int LPannerAudioProcessor::getRingSamples() const {
+	const double sampleRate = getSampleRate();
+	if (sampleRate <= 0.0) return 0;
+
+	// The soundfield rotation has no memory
+	if (ambisonicBus)
+		return 0;
+
+	// One more frame is overlap-added behind the STFT latency; bass mono is done per bin there
+	if (static_cast<int>(*stereoMode) == spectralChoice)
+		return spectralLatency;
+
+	// Classic mode keeps writing the delay line, so its whole history counts in every mode
+	int ringSamples = delayHistorySamples;
+
+	// Butterworth sections with Q = 1 / sqrt(2) decay at 2 pi f / sqrt(2) per second
+	if (*bassMono >= 0.5f) {
+		const double decayRate = juce::MathConstants<double>::twoPi * *bassMonoFreq / juce::MathConstants<double>::sqrt2;
+		ringSamples += static_cast<int>(std::ceil(RING_DECAY_NEPERS / decayRate * sampleRate));
+	}
+
+	return ringSamples;
+}
+
+// Returns true if the cached tail changed
+bool LPannerAudioProcessor::updateTailLength() {
+	const int granularity = juce::jmax(1, static_cast<int>(std::ceil(getSampleRate() * TAIL_GRANULARITY_MS * 0.001)));
+	const int tail = (getRingSamples() + granularity - 1) / granularity * granularity;
+	return tailSamples.exchange(tail) != tail;
+}
+
+// Time moves on for the smoothers, the LFO and the STFT frame grid as if the block had been processed
+void LPannerAudioProcessor::skipSilentBlock(int numSamples, bool modulating) {
+	for (auto& engine : spectralEnginesF) engine.skip(numSamples);
+	for (auto& engine : spectralEnginesD) engine.skip(numSamples);
+
+	// Same control points as a processed block
+	for (int startSample = 0, chunkSize = 0; startSample < numSamples; startSample += chunkSize) {
+		chunkSize = numSamples - startSample;
+		if (modulating)
+			chunkSize = applyModulation(chunkSize);
+
+		stereoSmoothed.skip(chunkSize);
+		stereoModeSmoothed.skip(chunkSize);
+		delaySmoothed.skip(chunkSize);
+		rotationSmoothed.skip(chunkSize);
+		dryWetSmoothed.skip(chunkSize);
+		pitchSmoothed.skip(chunkSize);
+		rollSmoothed.skip(chunkSize);
+	}
+}
+
+// The tier follows the host's render mode once per block, so no sample loop ever tests it
+void LPannerAudioProcessor::updateProcessingQuality() {
+	processingQuality = isNonRealtime() ? ProcessingQuality::offline : ProcessingQuality::realtime;
+
+	// The delayInterpolation choices are in DelayInterpolation order. Offline renders upgrade linear to
+	// Lagrange, which keeps the vectorized constant-delay read; an explicitly chosen Thiran is left alone.
+	auto interpolation = static_cast<DelayInterpolation>(static_cast<int>(*delayInterpolation));
+	if (processingQuality == ProcessingQuality::offline && interpolation == DelayInterpolation::linear)
+		interpolation = DelayInterpolation::lagrange3rd;
+
+	for (auto& delayLine : delayLinesF) delayLine.setInterpolation(interpolation);
+	for (auto& delayLine : delayLinesD) delayLine.setInterpolation(interpolation);
+}
+
+bool LPannerAudioProcessor::isSmoothing() const {
+	return stereoSmoothed.isSmoothing()
+		|| stereoModeSmoothed.isSmoothing()
+		|| delaySmoothed.isSmoothing()
+		|| rotationSmoothed.isSmoothing()
+		|| dryWetSmoothed.isSmoothing();
+}
+
+bool LPannerAudioProcessor::isAmbisonicSmoothing() const {
+	return rotationSmoothed.isSmoothing()
+		|| pitchSmoothed.isSmoothing()
+		|| rollSmoothed.isSmoothing()
+		|| dryWetSmoothed.isSmoothing();
 }
 
-void LPannerAudioProcessor::updateParameterValues(ProcessingState& state) {
+// The rotation knob is the yaw, so the LFO sweeps the scene around the listener
+AmbisonicRotator::Matrix LPannerAudioProcessor::getAmbisonicMatrix() const {
+	return AmbisonicRotator::makeMatrix(juce::degreesToRadians(static_cast<double>(rotationSmoothed.getCurrentValue())),
+		juce::degreesToRadians(static_cast<double>(pitchSmoothed.getCurrentValue())),
+		juce::degreesToRadians(static_cast<double>(rollSmoothed.getCurrentValue())),
+		dryWetSmoothed.getCurrentValue());
+}
+
+StereoMatrixKernel::Mode LPannerAudioProcessor::selectKernelMode() const {
+	// Targets are always 0 or 1, so a smoother at rest sits exactly on one of them
+	if (dryWetSmoothed.isSmoothing() || dryWetSmoothed.getTargetValue() < 1.0f)
+		return StereoMatrixKernel::Mode::bypassRamp;
+
+	if (stereoModeSmoothed.isSmoothing())
+		return StereoMatrixKernel::Mode::crossfade;
+
+	return stereoModeSmoothed.getTargetValue() > 0.0f ? StereoMatrixKernel::Mode::modern : StereoMatrixKernel::Mode::classic;
+}
+
+template <typename T>
+void LPannerAudioProcessor::updateChunkCoefficients(ProcessingState<T>& state, bool smoothing, int numSamples) {
+	// Both tiers are separate instantiations, picked once per chunk
+	if (processingQuality == ProcessingQuality::offline) {
+		if (smoothing) fillCoefficientRamps<ProcessingQuality::offline, T>(numSamples);
+		else updateParameterValues<ProcessingQuality::offline>(state);
+	}
+	else {
+		if (smoothing) fillCoefficientRamps<ProcessingQuality::realtime, T>(numSamples);
+		else updateParameterValues<ProcessingQuality::realtime>(state);
+	}
+}
+
+template <ProcessingQuality quality, typename T>
+void LPannerAudioProcessor::updateParameterValues(ProcessingState<T>& state) {
+	using C = CoefficientType<quality, T>;
+	ProcessingState<C> coefficientState;
+
 	// Get smoothed parameter values and calulate delay in samples and rotation coefficients
-	state.stereoWidth = stereoSmoothed.getNextValue() * 0.01f;
-	state.stereoMix = stereoModeSmoothed.getNextValue();
-	state.delaySamples = static_cast<int>((delaySmoothed.getNextValue() * getSampleRate()) * 0.001f);
-	state.cosTheta = std::cos(rotationSmoothed.getNextValue() / 180.0f * PI);
-	state.sinTheta = std::sin(rotationSmoothed.getNextValue() / 180.0f * PI);
-	state.wetMix = dryWetSmoothed.getNextValue();
+	const C rotationRadians = juce::degreesToRadians(static_cast<C>(rotationSmoothed.getNextValue()));
+
+	coefficientState.stereoWidth = static_cast<C>(stereoSmoothed.getNextValue()) * static_cast<C>(0.01);
+	coefficientState.stereoMix = static_cast<C>(stereoModeSmoothed.getNextValue());
+	coefficientState.delaySamples = static_cast<C>(delaySmoothed.getNextValue()) * static_cast<C>(delayMsToSamples);
+	coefficientState.cosTheta = std::cos(rotationRadians);
+	coefficientState.sinTheta = std::sin(rotationRadians);
+	coefficientState.wetMix = static_cast<C>(dryWetSmoothed.getNextValue());
+
+	updateCoefficients(coefficientState);
+	state = ProcessingState<T>::from(coefficientState);
+}
+
+template <typename T>
+void LPannerAudioProcessor::updateCoefficients(ProcessingState<T>& state) {
+	constexpr T half = static_cast<T>(0.5);
 
 	// Pre-calculate coefficients for classic algorithm
-	state.f1 = (1.0f + state.stereoWidth) * 0.5f;
-	state.f2 = (1.0f - state.stereoWidth) * 0.5f;
+	state.f1 = (1 + state.stereoWidth) * half;
+	state.f2 = (1 - state.stereoWidth) * half;
 
 	state.leftClassicCoefficient1 = state.f1 * state.cosTheta - state.f2 * state.sinTheta;
 	state.leftClassicCoefficient2 = state.f2 * state.cosTheta - state.f1 * state.sinTheta;
@@ -255,48 +930,141 @@ void LPannerAudioProcessor::updateParameterValues(ProcessingState& state) {
 	state.rightClassicCoefficient2 = state.f2 * state.sinTheta + state.f1 * state.cosTheta;
 
 	// Pre-calculate coefficients for modern algorithm
-	state.leftModernCoefficient = (state.stereoWidth - 1.0f) * (state.cosTheta + state.sinTheta) * 0.5f;
-	state.rightModernCoefficient = (state.stereoWidth - 1.0f) * (state.sinTheta - state.cosTheta) * 0.5f;
+	state.leftModernCoefficient = (state.stereoWidth - 1) * (state.cosTheta + state.sinTheta) * half;
+	state.rightModernCoefficient = (state.stereoWidth - 1) * (state.sinTheta - state.cosTheta) * half;
 }
 
-int LPannerAudioProcessor::calculateReadPosition(int delaySamples, int bufferSize) const {
-	int readPosition = writePosition - delaySamples;
-	if (readPosition < 0) readPosition += bufferSize;
-	return readPosition;
-}
+template <ProcessingQuality quality, typename T>
+void LPannerAudioProcessor::fillCoefficientRamps(int numSamples) {
+	auto** ramps = getCoefficientRamps<T>().getArrayOfWritePointers();
+
+	// Offline: exact cos/sin per sample and every coefficient derived in double, rounded only when stored
+	if constexpr (quality == ProcessingQuality::offline) {
+		ProcessingState<double> state;
+
+		for (int sampleIdx = 0; sampleIdx < numSamples; sampleIdx++) {
+			const double rotationRadians = juce::degreesToRadians(static_cast<double>(rotationSmoothed.getNextValue()));
+
+			state.stereoWidth = static_cast<double>(stereoSmoothed.getNextValue()) * 0.01;
+			state.stereoMix = static_cast<double>(stereoModeSmoothed.getNextValue());
+			state.delaySamples = static_cast<double>(delaySmoothed.getNextValue()) * delayMsToSamples;
+			state.cosTheta = std::cos(rotationRadians);
+			state.sinTheta = std::sin(rotationRadians);
+			state.wetMix = static_cast<double>(dryWetSmoothed.getNextValue());
+			updateCoefficients(state);
+
+			ramps[stereoWidthRamp][sampleIdx] = static_cast<T>(state.stereoWidth);
+			ramps[stereoMixRamp][sampleIdx] = static_cast<T>(state.stereoMix);
+			ramps[delaySamplesRamp][sampleIdx] = static_cast<T>(state.delaySamples);
+			ramps[rotationRamp][sampleIdx] = static_cast<T>(rotationRadians);
+			ramps[cosThetaRamp][sampleIdx] = static_cast<T>(state.cosTheta);
+			ramps[sinThetaRamp][sampleIdx] = static_cast<T>(state.sinTheta);
+			ramps[wetMixRamp][sampleIdx] = static_cast<T>(state.wetMix);
+			ramps[leftClassicCoefficient1Ramp][sampleIdx] = static_cast<T>(state.leftClassicCoefficient1);
+			ramps[leftClassicCoefficient2Ramp][sampleIdx] = static_cast<T>(state.leftClassicCoefficient2);
+			ramps[rightClassicCoefficient1Ramp][sampleIdx] = static_cast<T>(state.rightClassicCoefficient1);
+			ramps[rightClassicCoefficient2Ramp][sampleIdx] = static_cast<T>(state.rightClassicCoefficient2);
+			ramps[leftModernCoefficientRamp][sampleIdx] = static_cast<T>(state.leftModernCoefficient);
+			ramps[rightModernCoefficientRamp][sampleIdx] = static_cast<T>(state.rightModernCoefficient);
+		}
+		return;
+	}
+
+	// Realtime: the cheapest path, in the buffer's precision
+	const T msToSamples = static_cast<T>(delayMsToSamples);
+
+	// Advance every smoother exactly once per sample
+	for (int sampleIdx = 0; sampleIdx < numSamples; sampleIdx++) {
+		ramps[stereoWidthRamp][sampleIdx] = static_cast<T>(stereoSmoothed.getNextValue()) * static_cast<T>(0.01);
+		ramps[stereoMixRamp][sampleIdx] = static_cast<T>(stereoModeSmoothed.getNextValue());
+		ramps[delaySamplesRamp][sampleIdx] = static_cast<T>(delaySmoothed.getNextValue()) * msToSamples;
+		ramps[rotationRamp][sampleIdx] = juce::degreesToRadians(static_cast<T>(rotationSmoothed.getNextValue()));
+		ramps[wetMixRamp][sampleIdx] = static_cast<T>(dryWetSmoothed.getNextValue());
+	}
+
+	// The linear smoother moves the angle by a constant step, so rotate a phasor instead of calling
+	// cos/sin per sample. It is exact at both ends of the ramp, which bounds the drift to one chunk.
+	const auto* angles = ramps[rotationRamp];
+	const T finalAngle = angles[numSamples - 1];
+
+	int rampLength = numSamples;
+	while (rampLength > 1 && angles[rampLength - 2] == finalAngle) --rampLength;
+
+	RotationPhasor<T> rotationPhasor;
+	rotationPhasor.reset(angles[0]);
+	if (rampLength > 1)
+		rotationPhasor.setStep((finalAngle - angles[0]) / static_cast<T>(rampLength - 1));
 
-void LPannerAudioProcessor::incrementWritePosition(int bufferSize) {
-	++writePosition;
-	if (writePosition >= bufferSize) writePosition = 0;
+	for (int sampleIdx = 0; sampleIdx < numSamples; sampleIdx++) {
+		if (sampleIdx == rampLength - 1)
+			rotationPhasor.reset(finalAngle);
+		else if (sampleIdx > 0 && sampleIdx < rampLength)
+			rotationPhasor.advance();
 
+		ramps[cosThetaRamp][sampleIdx] = rotationPhasor.cosTheta;
+		ramps[sinThetaRamp][sampleIdx] = rotationPhasor.sinTheta;
+	}
+
+	// Derive the matrix coefficients from the filled ramps
+	ProcessingState<T> state;
+
+	for (int sampleIdx = 0; sampleIdx < numSamples; sampleIdx++) {
+		state.stereoWidth = ramps[stereoWidthRamp][sampleIdx];
+		state.cosTheta = ramps[cosThetaRamp][sampleIdx];
+		state.sinTheta = ramps[sinThetaRamp][sampleIdx];
+		updateCoefficients(state);
+
+		ramps[leftClassicCoefficient1Ramp][sampleIdx] = state.leftClassicCoefficient1;
+		ramps[leftClassicCoefficient2Ramp][sampleIdx] = state.leftClassicCoefficient2;
+		ramps[rightClassicCoefficient1Ramp][sampleIdx] = state.rightClassicCoefficient1;
+		ramps[rightClassicCoefficient2Ramp][sampleIdx] = state.rightClassicCoefficient2;
+		ramps[leftModernCoefficientRamp][sampleIdx] = state.leftModernCoefficient;
+		ramps[rightModernCoefficientRamp][sampleIdx] = state.rightModernCoefficient;
+	}
 }
 
 //==============================================================================
 bool LPannerAudioProcessor::hasEditor() const
 {
+#if LPANNER_HEADLESS
+	return false;
+#else
 	return true; // (change this to false if you choose to not supply an editor)
+#endif
 }
 
 juce::AudioProcessorEditor* LPannerAudioProcessor::createEditor()
 {
+#if LPANNER_HEADLESS
+	return nullptr;
+#elif LPANNER_WEB_EDITOR
+	// LPANNER_EDITOR=native picks the lightweight editor without rebuilding
+	if (juce::SystemStats::getEnvironmentVariable("LPANNER_EDITOR", {}).equalsIgnoreCase("native"))
+		return new LPannerNativeEditor(*this);
+
 	return new LPannerAudioProcessorEditor(*this);
+#else
+	return new LPannerNativeEditor(*this);
+#endif
 }
 
 //==============================================================================
 void LPannerAudioProcessor::getStateInformation(juce::MemoryBlock& destData)
 {
-	// You should use this method to store your parameters in the memory block.
-	// You could do that either as raw data, or use the XML or ValueTree classes
-	// as intermediaries to make it easy to save and load complex data.
-	auto state = parameters.copyState();
-	std::unique_ptr<juce::XmlElement> xml(state.createXml());
-	copyXmlToBinary(*xml, destData);
+	// Compact binary state, written straight into destData; see BinaryState.h for the layout
+	BinaryState::write(destData, stateEntries);
 }
 
 void LPannerAudioProcessor::setStateInformation(const void* data, int sizeInBytes)
 {
 	// You should use this method to restore your parameters from this memory block,
 	// whose contents will have been created by the getStateInformation() call.
+	if (BinaryState::isBinaryState(data, sizeInBytes)) {
+		BinaryState::read(data, sizeInBytes, stateEntries);
+		return;
+	}
+
+	// XML states from earlier versions
 	std::unique_ptr<juce::XmlElement> xmlState(getXmlFromBinary(data, sizeInBytes));
 	if (xmlState.get() != nullptr && xmlState->hasTagName(parameters.state.getType()))
 		parameters.replaceState(juce::ValueTree::fromXml(*xmlState));
@@ -9,11 +9,40 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "StereoMatrixKernel.h"
+#include "MidDelayLine.h"
+#include "BassMonoCrossover.h"
+#include "SpectralWidthEngine.h"
+#include "StereoAnalyser.h"
+#include "DspLoadMeter.h"
+#include "BinaryState.h"
+#include "ModulationLfo.h"
+#include "AmbisonicRotator.h"
+
+// LPANNER_NATIVE_EDITOR=1 builds only the native editor, without the WebView and its assets
+#ifndef LPANNER_NATIVE_EDITOR
+ #define LPANNER_NATIVE_EDITOR 0
+#endif
+
+#if ! LPANNER_HEADLESS && ! LPANNER_NATIVE_EDITOR && JUCE_WEB_BROWSER
+ #define LPANNER_WEB_EDITOR 1
+ #include "WebAssetCache.h"
+#else
+ #define LPANNER_WEB_EDITOR 0
+#endif
+
+// Offline renders (isNonRealtime) spend CPU on accuracy; live playback takes the cheapest path
+enum class ProcessingQuality {
+	realtime,
+	offline
+};
 
 //==============================================================================
 /**
 */
-class LPannerAudioProcessor : public juce::AudioProcessor
+class LPannerAudioProcessor : public juce::AudioProcessor,
+	private juce::AudioProcessorValueTreeState::Listener,
+	private juce::AsyncUpdater
 {
 public:
 	//==============================================================================
@@ -63,21 +92,46 @@ public:
 		juce::Identifier("PARAMETERS"),
 		{
 			std::make_unique<juce::AudioParameterFloat>("stereo", "stereo", juce::NormalisableRange<float>(0.0f, 200.0f, 0.1f, 1), 100.0f),
-			std::make_unique<juce::AudioParameterChoice>("stereoMode", "stereoMode", juce::StringArray("classic", "modern"), 1),
+			std::make_unique<juce::AudioParameterChoice>("stereoMode", "stereoMode", juce::StringArray("classic", "modern", "spectral"), 1),
 			std::make_unique<juce::AudioParameterFloat>("delay", "delay", juce::NormalisableRange<float>(1.0f, 20.0f, 0.1f, 1), 5.0f),
 			std::make_unique<juce::AudioParameterFloat>("rotation", "rotation", juce::NormalisableRange<float>(-50.0f,50.0f, 0.1f, 1), 0.0f),
 			std::make_unique<juce::AudioParameterBool>("bypass", "bypass", false),
+			std::make_unique<juce::AudioParameterBool>("bassMono", "bassMono", false),
+			std::make_unique<juce::AudioParameterFloat>("bassMonoFreq", "bassMonoFreq", juce::NormalisableRange<float>(20.0f, 500.0f, 1.0f, 0.5f), 120.0f),
+			std::make_unique<juce::AudioParameterChoice>("bassMonoSlope", "bassMonoSlope", juce::StringArray("12 dB/oct", "24 dB/oct"), 1),
+			std::make_unique<juce::AudioParameterFloat>("spectralLowWidth", "spectralLowWidth", juce::NormalisableRange<float>(0.0f, 200.0f, 0.1f, 1), 100.0f),
+			std::make_unique<juce::AudioParameterChoice>("lfoShape", "lfoShape", juce::StringArray("sine", "triangle", "sample & hold"), 0),
+			std::make_unique<juce::AudioParameterBool>("lfoSync", "lfoSync", false),
+			std::make_unique<juce::AudioParameterFloat>("lfoRate", "lfoRate", juce::NormalisableRange<float>(0.01f, 20.0f, 0.01f, 0.3f), 0.5f),
+			std::make_unique<juce::AudioParameterChoice>("lfoSyncRate", "lfoSyncRate", juce::StringArray("4 bars", "2 bars", "1 bar", "1/2", "1/4", "1/8", "1/16"), 2),
+			std::make_unique<juce::AudioParameterFloat>("lfoDepth", "lfoDepth", juce::NormalisableRange<float>(0.0f, 50.0f, 0.1f, 1), 0.0f),
+			std::make_unique<juce::AudioParameterFloat>("lfoWidthDepth", "lfoWidthDepth", juce::NormalisableRange<float>(0.0f, 100.0f, 0.1f, 1), 0.0f),
+			std::make_unique<juce::AudioParameterFloat>("lfoPhase", "lfoPhase", juce::NormalisableRange<float>(0.0f, 360.0f, 1.0f, 1), 0.0f),
+			std::make_unique<juce::AudioParameterFloat>("pitch", "pitch", juce::NormalisableRange<float>(-180.0f, 180.0f, 0.1f, 1), 0.0f),
+			std::make_unique<juce::AudioParameterFloat>("roll", "roll", juce::NormalisableRange<float>(-180.0f, 180.0f, 0.1f, 1), 0.0f),
+			std::make_unique<juce::AudioParameterChoice>("delayInterpolation", "delayInterpolation", juce::StringArray("linear", "lagrange", "thiran"), 0),
 		}
 	};
 	juce::AudioProcessorParameter* getBypassParameter() const {
 		return parameters.getParameter("bypass");
 	}
 
+	// Metering of the main output pair, started and read by the editor
+	StereoAnalyser& getAnalyser() { return analyser; }
+
+	// Block timing against the real-time budget; setting LPANNER_TRACE_DIR also writes a Chrome trace per instance
+	DspLoadMeter& getLoadMeter() { return loadMeter; }
+
 private:
 	// Consts
 	static constexpr double SMOOTHING_TIME_MS = 10.0;
-	static constexpr double DELAY_SECS = 2.0;
-	static constexpr double PI = 3.14159265398979;
+
+	// stereoMode choices
+	enum StereoModeChoice {
+		classicChoice,
+		modernChoice,
+		spectralChoice
+	};
 
 	// Params Refs
 	std::atomic<float>* stereo = parameters.getRawParameterValue("stereo");
@@ -85,6 +139,20 @@ private:
 	std::atomic<float>* delay = parameters.getRawParameterValue("delay");
 	std::atomic<float>* rotation = parameters.getRawParameterValue("rotation");
 	std::atomic<float>* bypass = parameters.getRawParameterValue("bypass");
+	std::atomic<float>* bassMono = parameters.getRawParameterValue("bassMono");
+	std::atomic<float>* bassMonoFreq = parameters.getRawParameterValue("bassMonoFreq");
+	std::atomic<float>* bassMonoSlope = parameters.getRawParameterValue("bassMonoSlope");
+	std::atomic<float>* spectralLowWidth = parameters.getRawParameterValue("spectralLowWidth");
+	std::atomic<float>* lfoShape = parameters.getRawParameterValue("lfoShape");
+	std::atomic<float>* lfoSync = parameters.getRawParameterValue("lfoSync");
+	std::atomic<float>* lfoRate = parameters.getRawParameterValue("lfoRate");
+	std::atomic<float>* lfoSyncRate = parameters.getRawParameterValue("lfoSyncRate");
+	std::atomic<float>* lfoDepth = parameters.getRawParameterValue("lfoDepth");
+	std::atomic<float>* lfoWidthDepth = parameters.getRawParameterValue("lfoWidthDepth");
+	std::atomic<float>* lfoPhase = parameters.getRawParameterValue("lfoPhase");
+	std::atomic<float>* pitch = parameters.getRawParameterValue("pitch");
+	std::atomic<float>* roll = parameters.getRawParameterValue("roll");
+	std::atomic<float>* delayInterpolation = parameters.getRawParameterValue("delayInterpolation");
 
 	// Smoothed Params
 	juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> stereoSmoothed;
@@ -92,54 +160,316 @@ private:
 	juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> delaySmoothed;
 	juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> rotationSmoothed;
 	juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> dryWetSmoothed;
+	juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> pitchSmoothed;
+	juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> rollSmoothed;
 
-	// Audio Processing State
+	// Audio Processing State (in the precision of the buffer being processed)
+	template <typename T>
 	struct ProcessingState {
-		float stereoWidth = 1.0f;
-		float stereoMix = 0.0f;
-		int delaySamples = 0;
-		float cosTheta = 1.0f;
-		float sinTheta = 0.0f;
-		float wetMix = 1.0f;
-
-		float f1 = 1.0f;
-		float f2 = 0.0f;
-		float leftClassicCoefficient1 = 1.0f, leftClassicCoefficient2 = 0.0f;
-		float rightClassicCoefficient1 = 0.0f, rightClassicCoefficient2 = 1.0f;
-
-		float leftModernCoefficient = 0.0f;
-		float rightModernCoefficient = 0.0f;
+		T stereoWidth = 1;
+		T stereoMix = 0;
+		T delaySamples = 0;
+		T cosTheta = 1;
+		T sinTheta = 0;
+		T wetMix = 1;
+
+		T f1 = 1;
+		T f2 = 0;
+		T leftClassicCoefficient1 = 1, leftClassicCoefficient2 = 0;
+		T rightClassicCoefficient1 = 0, rightClassicCoefficient2 = 1;
+
+		T leftModernCoefficient = 0;
+		T rightModernCoefficient = 0;
+
+		// Rounds a state computed in another precision
+		template <typename U>
+		static ProcessingState from(const ProcessingState<U>& other) {
+			ProcessingState state;
+			state.stereoWidth = static_cast<T>(other.stereoWidth);
+			state.stereoMix = static_cast<T>(other.stereoMix);
+			state.delaySamples = static_cast<T>(other.delaySamples);
+			state.cosTheta = static_cast<T>(other.cosTheta);
+			state.sinTheta = static_cast<T>(other.sinTheta);
+			state.wetMix = static_cast<T>(other.wetMix);
+			state.f1 = static_cast<T>(other.f1);
+			state.f2 = static_cast<T>(other.f2);
+			state.leftClassicCoefficient1 = static_cast<T>(other.leftClassicCoefficient1);
+			state.leftClassicCoefficient2 = static_cast<T>(other.leftClassicCoefficient2);
+			state.rightClassicCoefficient1 = static_cast<T>(other.rightClassicCoefficient1);
+			state.rightClassicCoefficient2 = static_cast<T>(other.rightClassicCoefficient2);
+			state.leftModernCoefficient = static_cast<T>(other.leftModernCoefficient);
+			state.rightModernCoefficient = static_cast<T>(other.rightModernCoefficient);
+			return state;
+		}
+	};
+
+	// Precision the coefficients are derived in: the buffer's in realtime, always double offline
+	template <ProcessingQuality quality, typename T>
+	using CoefficientType = std::conditional_t<quality == ProcessingQuality::offline, double, T>;
+
+	// Incremental cos/sin recurrence for a linearly ramping rotation angle
+	template <typename T>
+	struct RotationPhasor {
+		T cosTheta = 1, sinTheta = 0;
+		T cosDelta = 1, sinDelta = 0;
+
+		void reset(T angleRadians) {
+			cosTheta = std::cos(angleRadians);
+			sinTheta = std::sin(angleRadians);
+		}
+
+		void setStep(T stepRadians) {
+			cosDelta = std::cos(stepRadians);
+			sinDelta = std::sin(stepRadians);
+		}
+
+		void advance() {
+			const T nextCos = cosTheta * cosDelta - sinTheta * sinDelta;
+			const T nextSin = sinTheta * cosDelta + cosTheta * sinDelta;
+
+			// First-order renormalisation keeps the phasor on the unit circle
+			const T gain = static_cast<T>(1.5) - static_cast<T>(0.5) * (nextCos * nextCos + nextSin * nextSin);
+			cosTheta = nextCos * gain;
+			sinTheta = nextSin * gain;
+		}
+	};
+
+	// Coefficient Ramps (one channel per coefficient, filled once per block while smoothing)
+	enum RampChannel {
+		stereoWidthRamp,
+		rotationRamp,
+		stereoMixRamp,
+		delaySamplesRamp,
+		cosThetaRamp,
+		sinThetaRamp,
+		wetMixRamp,
+		leftClassicCoefficient1Ramp,
+		leftClassicCoefficient2Ramp,
+		rightClassicCoefficient1Ramp,
+		rightClassicCoefficient2Ramp,
+		leftModernCoefficientRamp,
+		rightModernCoefficientRamp,
+		numRampChannels
+	};
+	juce::AudioBuffer<float> coefficientRampsF;
+	juce::AudioBuffer<double> coefficientRampsD;
+
+	// Channel Pairs (L/R, Ls/Rs, ...) that share the coefficients of a chunk; right is -1 on a mono bus
+	struct ChannelPair {
+		int left = 0;
+		int right = 1;
 	};
+	std::vector<ChannelPair> channelPairs;
+	std::vector<int> passThroughChannels;
+
+	// Delay Lines (one per channel pair, only the precision in use is allocated)
+	std::vector<MidDelayLine<float>> delayLinesF;
+	std::vector<MidDelayLine<double>> delayLinesD;
+	ProcessingQuality processingQuality = ProcessingQuality::realtime;
+	double delayMsToSamples = 0.0;
+
+	// Bass Mono Crossovers (one per channel pair, filter state is per pair)
+	std::vector<BassMonoCrossover<float>> crossoversF;
+	std::vector<BassMonoCrossover<double>> crossoversD;
+
+	// Spectral Mode (one STFT per channel pair, one bin matrix shared by all of them).
+	// Channels without a pair are delayed by the STFT latency so the bus stays aligned.
+	SpectralMatrix spectralMatrix;
+	std::vector<SpectralWidthEngine<float>> spectralEnginesF;
+	std::vector<SpectralWidthEngine<double>> spectralEnginesD;
+	juce::dsp::DelayLine<float, juce::dsp::DelayLineInterpolationTypes::None> latencyCompensationF;
+	juce::dsp::DelayLine<double, juce::dsp::DelayLineInterpolationTypes::None> latencyCompensationD;
+	int spectralLatency = 0;
+	bool spectralActive = false;
+
+	// The audio thread only resets its state on a switch; latency and tail are reported from the message thread
+	void parameterChanged(const juce::String& parameterID, float newValue) override;
+	void handleAsyncUpdate() override;
+	int getTargetLatency() const;
 
-	// Delay Buffer
-	juce::AudioBuffer<float> delayBufferF;
-	juce::AudioBuffer<double> delayBufferD;
-	int writePosition = 0;
+	// First-order ambisonic bus: rotation is the yaw, pitch and roll tilt the scene, and the stereo
+	// controls do not apply. The matrix is recomputed every AMBISONIC_CONTROL_INTERVAL samples while
+	// an angle moves and interpolated in between.
+	static constexpr int AMBISONIC_CONTROL_INTERVAL = 32;
+	bool ambisonicBus = false;
+	AmbisonicRotator ambisonicRotator;
+
+	// Rotation/width LFO, evaluated every modulationInterval samples (one smoothing ramp).
+	// Control points run on their own grid across block boundaries.
+	ModulationLfo lfo;
+	int modulationInterval = 1;
+	int samplesToControlPoint = 0;
+	static constexpr double DEFAULT_TEMPO_BPM = 120.0;
+
+	// Silence detection: a block is left untouched once the input has been silent for longer than
+	// the output can ring (see getRingSamples)
+	static constexpr float SILENCE_THRESHOLD = 1.0e-6f;	// -120 dB
+	static constexpr double RING_DECAY_NEPERS = 16.0;	// -120 dB is 13.8, plus margin for the repeated LR4 poles
+	juce::int64 silentSamples = 0;
+
+	// Tail reported to the host, cached so the message thread never touches the processing state.
+	// Rounded up to TAIL_GRANULARITY_MS so a crossover sweep does not notify the host on every step.
+	static constexpr double TAIL_GRANULARITY_MS = 10.0;
+	int delayHistorySamples = 0;
+	std::atomic<int> tailSamples{ 0 };
+
+	// Parameters in state order, with their ID hashes
+	std::vector<BinaryState::Entry> stateEntries;
+
+	// Output Metering
+	StereoAnalyser analyser;
+	DspLoadMeter loadMeter;
+
+#if LPANNER_WEB_EDITOR
+	// Keeps the editors' asset cache alive between editor opens; it is only filled on the first open
+	juce::SharedResourcePointer<WebAssetCache> webAssets;
+#endif
+
+	// Per-chunk scratch, reused by every channel pair
+	enum ScratchChannel {
+		midDelayScratch,	// delayed mid signal, read out of the delay line in one go
+		monoRightScratch,	// right half of the dual-mono pair on a mono bus
+		numScratchChannels
+	};
+	juce::AudioBuffer<float> scratchBufferF;
+	juce::AudioBuffer<double> scratchBufferD;
 
 	// Helper Methods
-	void updateDelayBufferSize(double sampleRate);
-	void setTargetValue();
-	void updateParameterValues(ProcessingState& state);
-	int calculateReadPosition(int delaySamples, int bufferSize) const;
-	void incrementWritePosition(int bufferSize);
+	void updateChannelPairs();
+	void updateBufferSizes(double sampleRate, int chunkSize);
+	void setTargetValue(bool modulating);
+	bool updateModulation();
+	int applyModulation(int maxSamples);
+	int getRingSamples() const;
+	bool updateTailLength();
+	void skipSilentBlock(int numSamples, bool modulating);
+	void updateProcessingQuality();
+	bool isSmoothing() const;
+	bool isAmbisonicSmoothing() const;
+	AmbisonicRotator::Matrix getAmbisonicMatrix() const;
+	StereoMatrixKernel::Mode selectKernelMode() const;
 
 	// Template Methods
 	template <typename T>
 	void processBlockImpl(juce::AudioBuffer<T>& buffer, juce::MidiBuffer& midiMessages);
 
+	template <ProcessingQuality quality, typename T>
+	void updateParameterValues(ProcessingState<T>& state);
+
+	template <typename T>
+	static void updateCoefficients(ProcessingState<T>& state);
+
+	template <ProcessingQuality quality, typename T>
+	void fillCoefficientRamps(int numSamples);
+
+	template <typename T>
+	void updateChunkCoefficients(ProcessingState<T>& state, bool smoothing, int numSamples);
+
+	template <typename T, typename Coefficients, typename ReadDelay>
+	void processPair(T* leftPtr, T* rightPtr, int numSamples, StereoMatrixKernel::Mode mode, MidDelayLine<T>& delayLine, BassMonoCrossover<T>* crossover, const Coefficients& coefficients, ReadDelay&& readDelay);
+
+	template <typename T>
+	void processStatic(T* leftPtr, T* rightPtr, int numSamples, const ProcessingState<T>& state, StereoMatrixKernel::Mode mode, MidDelayLine<T>& delayLine, BassMonoCrossover<T>* crossover);
+
+	template <typename T>
+	void processRamped(T* leftPtr, T* rightPtr, int numSamples, StereoMatrixKernel::Mode mode, MidDelayLine<T>& delayLine, BassMonoCrossover<T>* crossover);
+
+	template <typename T>
+	void processBypassed(const juce::AudioBuffer<T>& buffer, bool bassMonoEnabled);
+
+	template <typename T>
+	bool isSilent(const juce::AudioBuffer<T>& buffer) const;
+
+	template <typename T>
+	void processSpectral(juce::AudioBuffer<T>& buffer, bool modulating);
+
+	template <typename T>
+	void processAmbisonic(juce::AudioBuffer<T>& buffer, bool modulating);
+
+	template <typename T>
+	void resetProcessingState();
+
+	template <typename T>
+	void pushAnalysis(const juce::AudioBuffer<T>& buffer);
+
+	template<typename T>
+	juce::AudioBuffer<T>& getCoefficientRamps();
+
 	template<typename T>
-	juce::AudioBuffer<T>& getDelayBuffer();
+	std::vector<MidDelayLine<T>>& getDelayLines();
+
+	template<typename T>
+	std::vector<BassMonoCrossover<T>>& getCrossovers();
+
+	template<typename T>
+	std::vector<SpectralWidthEngine<T>>& getSpectralEngines();
+
+	template<typename T>
+	juce::dsp::DelayLine<T, juce::dsp::DelayLineInterpolationTypes::None>& getLatencyCompensation();
+
+	template<typename T>
+	juce::AudioBuffer<T>& getScratchBuffer();
 
 	//==============================================================================
 	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LPannerAudioProcessor)
 };
 
 template<>
-inline juce::AudioBuffer<float>& LPannerAudioProcessor::getDelayBuffer<float>() {
-	return delayBufferF;
+inline juce::AudioBuffer<float>& LPannerAudioProcessor::getCoefficientRamps<float>() {
+	return coefficientRampsF;
+}
+
+template<>
+inline juce::AudioBuffer<double>& LPannerAudioProcessor::getCoefficientRamps<double>() {
+	return coefficientRampsD;
 }
 
 template<>
-inline juce::AudioBuffer<double>& LPannerAudioProcessor::getDelayBuffer<double>() {
-	return delayBufferD;
-}
\ No newline at end of file
+inline std::vector<MidDelayLine<float>>& LPannerAudioProcessor::getDelayLines<float>() {
+	return delayLinesF;
+}
+
+template<>
+inline std::vector<MidDelayLine<double>>& LPannerAudioProcessor::getDelayLines<double>() {
+	return delayLinesD;
+}
+
+template<>
+inline std::vector<BassMonoCrossover<float>>& LPannerAudioProcessor::getCrossovers<float>() {
+	return crossoversF;
+}
+
+template<>
+inline std::vector<BassMonoCrossover<double>>& LPannerAudioProcessor::getCrossovers<double>() {
+	return crossoversD;
+}
+
+template<>
+inline std::vector<SpectralWidthEngine<float>>& LPannerAudioProcessor::getSpectralEngines<float>() {
+	return spectralEnginesF;
+}
+
+template<>
+inline std::vector<SpectralWidthEngine<double>>& LPannerAudioProcessor::getSpectralEngines<double>() {
+	return spectralEnginesD;
+}
+
+template<>
+inline juce::dsp::DelayLine<float, juce::dsp::DelayLineInterpolationTypes::None>& LPannerAudioProcessor::getLatencyCompensation<float>() {
+	return latencyCompensationF;
+}
+
+template<>
+inline juce::dsp::DelayLine<double, juce::dsp::DelayLineInterpolationTypes::None>& LPannerAudioProcessor::getLatencyCompensation<double>() {
+	return latencyCompensationD;
+}
+
+template<>
+inline juce::AudioBuffer<float>& LPannerAudioProcessor::getScratchBuffer<float>() {
+	return scratchBufferF;
+}
+
+template<>
+inline juce::AudioBuffer<double>& LPannerAudioProcessor::getScratchBuffer<double>() {
+	return scratchBufferD;
+}
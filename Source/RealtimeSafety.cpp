@@ -0,0 +1,195 @@
+/*
+  ==============================================================================
+
+	Interposed allocator, lock and system call entry points for
+	LPANNER_RT_CHECKS builds.
+
+  ==============================================================================
+*/
+
+#include "RealtimeSafety.h"
+
+#if LPANNER_RT_CHECKS
+
+#if ! JUCE_LINUX
+ #error "LPANNER_RT_CHECKS interposes glibc symbols and is only available on Linux"
+#endif
+
+#include <dlfcn.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <cerrno>
+#include <cstdlib>
+#include <cstdarg>
+#include <cstring>
+#include <ctime>
+
+// glibc's own allocator entry points, so the replacements below never recurse
+extern "C" {
+	void* __libc_malloc(size_t size);
+	void* __libc_calloc(size_t count, size_t size);
+	void* __libc_realloc(void* ptr, size_t size);
+	void* __libc_memalign(size_t alignment, size_t size);
+	void __libc_free(void* ptr);
+}
+
+namespace RealtimeSafety {
+	namespace {
+		constexpr int MAX_REPORTED_VIOLATIONS = 32;
+
+		thread_local int realtimeDepth = 0;
+		thread_local bool reporting = false;
+		std::atomic<int> violationCount{ 0 };
+
+		// Trivial types only: these run before static constructors and inside the allocator
+		bool shouldAbort() {
+			static const bool abortOnViolation = std::getenv("LPANNER_RT_CHECKS_ABORT") != nullptr;
+			return abortOnViolation;
+		}
+
+		void writeToStandardError(const char* text) {
+			::write(STDERR_FILENO, text, std::strlen(text));
+		}
+
+		// Reporting itself writes and may lock, so checks are off until it returns
+		void check(const char* function) {
+			if (realtimeDepth == 0 || reporting) return;
+
+			reporting = true;
+			const int count = violationCount.fetch_add(1, std::memory_order_relaxed) + 1;
+
+			if (count <= MAX_REPORTED_VIOLATIONS) {
+				writeToStandardError("LPanner RT check: ");
+				writeToStandardError(function);
+				writeToStandardError(" called inside a realtime section\n");
+			}
+
+			if (shouldAbort()) std::abort();
+			reporting = false;
+		}
+
+		template <typename Function>
+		Function getNext(const char* name) {
+			return reinterpret_cast<Function>(dlsym(RTLD_NEXT, name));
+		}
+	}
+
+	void enterRealtimeSection() noexcept { ++realtimeDepth; }
+	void exitRealtimeSection() noexcept { --realtimeDepth; }
+
+	int getViolationCount() noexcept { return violationCount.load(std::memory_order_relaxed); }
+	void resetViolationCount() noexcept { violationCount = 0; }
+}
+
+//==============================================================================
+using RealtimeSafety::check;
+using RealtimeSafety::getNext;
+
+extern "C" {
+	// Allocator
+	void* malloc(size_t size) {
+		check("malloc");
+		return __libc_malloc(size);
+	}
+
+	void* calloc(size_t count, size_t size) {
+		check("calloc");
+		return __libc_calloc(count, size);
+	}
+
+	void* realloc(void* ptr, size_t size) {
+		check("realloc");
+		return __libc_realloc(ptr, size);
+	}
+
+	void free(void* ptr) {
+		if (ptr != nullptr) check("free");
+		__libc_free(ptr);
+	}
+
+	int posix_memalign(void** ptr, size_t alignment, size_t size) {
+		check("posix_memalign");
+		*ptr = __libc_memalign(alignment, size);
+		return *ptr != nullptr ? 0 : ENOMEM;
+	}
+
+	void* aligned_alloc(size_t alignment, size_t size) {
+		check("aligned_alloc");
+		return __libc_memalign(alignment, size);
+	}
+
+	// Locks and waits
+	int pthread_mutex_lock(pthread_mutex_t* mutex) {
+		static const auto next = getNext<int (*)(pthread_mutex_t*)>("pthread_mutex_lock");
+		check("pthread_mutex_lock");
+		return next(mutex);
+	}
+
+	int pthread_cond_wait(pthread_cond_t* condition, pthread_mutex_t* mutex) {
+		static const auto next = getNext<int (*)(pthread_cond_t*, pthread_mutex_t*)>("pthread_cond_wait");
+		check("pthread_cond_wait");
+		return next(condition, mutex);
+	}
+
+	int pthread_cond_timedwait(pthread_cond_t* condition, pthread_mutex_t* mutex, const struct timespec* time) {
+		static const auto next = getNext<int (*)(pthread_cond_t*, pthread_mutex_t*, const struct timespec*)>("pthread_cond_timedwait");
+		check("pthread_cond_timedwait");
+		return next(condition, mutex, time);
+	}
+
+	int sched_yield() {
+		static const auto next = getNext<int (*)()>("sched_yield");
+		check("sched_yield");
+		return next();
+	}
+
+	int nanosleep(const struct timespec* duration, struct timespec* remaining) {
+		static const auto next = getNext<int (*)(const struct timespec*, struct timespec*)>("nanosleep");
+		check("nanosleep");
+		return next(duration, remaining);
+	}
+
+	int usleep(useconds_t microseconds) {
+		static const auto next = getNext<int (*)(useconds_t)>("usleep");
+		check("usleep");
+		return next(microseconds);
+	}
+
+	// File and device I/O
+	int open(const char* path, int flags, ...) {
+		static const auto next = getNext<int (*)(const char*, int, ...)>("open");
+		check("open");
+
+		mode_t mode = 0;
+		if ((flags & O_CREAT) != 0 || (flags & O_TMPFILE) == O_TMPFILE) {
+			va_list args;
+			va_start(args, flags);
+			mode = static_cast<mode_t>(va_arg(args, int));
+			va_end(args);
+		}
+
+		return next(path, flags, mode);
+	}
+
+	int close(int fd) {
+		static const auto next = getNext<int (*)(int)>("close");
+		check("close");
+		return next(fd);
+	}
+
+	ssize_t read(int fd, void* buffer, size_t size) {
+		static const auto next = getNext<ssize_t (*)(int, void*, size_t)>("read");
+		check("read");
+		return next(fd, buffer, size);
+	}
+
+	ssize_t write(int fd, const void* buffer, size_t size) {
+		static const auto next = getNext<ssize_t (*)(int, const void*, size_t)>("write");
+		check("write");
+		return next(fd, buffer, size);
+	}
+}
+
+#endif
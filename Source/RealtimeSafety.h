@@ -0,0 +1,48 @@
+/*
+  ==============================================================================
+
+	Real-time safety checks for the audio thread (LPANNER_RT_CHECKS builds).
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#ifndef LPANNER_RT_CHECKS
+ #define LPANNER_RT_CHECKS 0
+#endif
+
+//==============================================================================
+/**
+	With LPANNER_RT_CHECKS=1 (Linux only) RealtimeSafety.cpp interposes the allocator, mutex
+	locks and blocking system calls. Any of them reached while a thread is inside a realtime
+	section counts as a violation and is reported on stderr, or aborts the process when
+	LPANNER_RT_CHECKS_ABORT is set in the environment. Meant for debug and CI runs of the headless
+	tools; it replaces malloc, so it cannot be combined with AddressSanitizer.
+
+	In normal builds LPANNER_REALTIME_SCOPE expands to nothing.
+*/
+namespace RealtimeSafety {
+#if LPANNER_RT_CHECKS
+	void enterRealtimeSection() noexcept;
+	void exitRealtimeSection() noexcept;
+
+	int getViolationCount() noexcept;
+	void resetViolationCount() noexcept;
+
+	struct ScopedRealtimeSection {
+		ScopedRealtimeSection() noexcept { enterRealtimeSection(); }
+		~ScopedRealtimeSection() noexcept { exitRealtimeSection(); }
+
+		JUCE_DECLARE_NON_COPYABLE(ScopedRealtimeSection)
+	};
+#endif
+}
+
+#if LPANNER_RT_CHECKS
+ #define LPANNER_REALTIME_SCOPE const RealtimeSafety::ScopedRealtimeSection realtimeSection
+#else
+ #define LPANNER_REALTIME_SCOPE
+#endif
@@ -0,0 +1,279 @@
+/*
+  ==============================================================================
+
+	STFT engine of the spectral stereo mode: a frequency-dependent width
+	curve applied to every bin of a stereo pair.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "StereoMatrixKernel.h"
+
+//==============================================================================
+/**
+	Per-bin 2x2 matrix shared by every channel pair of a block.
+
+	Each bin gets the classic width/rotation matrix for the width of its frequency: the curve is
+	linear in log frequency from lowWidth at 20 Hz to highWidth at 20 kHz. Bins below the bass mono
+	cutoff are summed to mono instead. Entries are stored duplicated for the real and imaginary
+	part, in the interleaved layout the FFT produces, so the frame pass is a plain multiply-add.
+*/
+class SpectralMatrix {
+public:
+	enum Entry {
+		leftFromLeft,
+		leftFromRight,
+		rightFromLeft,
+		rightFromRight,
+		numEntries
+	};
+
+	//==============================================================================
+	void prepare(double sampleRate, int fftSize) {
+		const int numBins = fftSize / 2 + 1;
+		constexpr int vectorSize = static_cast<int>(StereoMatrixKernel::Vec<float>::size());
+
+		// Padded to whole registers; the FFT buffers are twice the FFT size, so the padding stays inside them
+		numValues = (2 * numBins + vectorSize - 1) / vectorSize * vectorSize;
+		binFrequency = static_cast<float>(sampleRate / fftSize);
+
+		for (auto& entry : entries) entry.assign(static_cast<size_t>(numValues), 0.0f);
+
+		// Position of every bin on the width curve, fixed for the sample rate
+		binPosition.resize(static_cast<size_t>(numBins));
+		for (int binIdx = 0; binIdx < numBins; binIdx++) {
+			const float frequency = juce::jmax(binIdx * binFrequency, MIN_FREQUENCY);
+			binPosition[static_cast<size_t>(binIdx)] = juce::jlimit(0.0f, 1.0f, std::log(frequency / MIN_FREQUENCY) / std::log(MAX_FREQUENCY / MIN_FREQUENCY));
+		}
+
+		lastSettings = {};
+		identity = false;
+	}
+
+	// Only recomputed when a setting changed, so calling it every chunk costs one comparison at rest
+	void update(float lowWidth, float highWidth, float rotationRadians, float wetMix, float monoBelowHz) {
+		const Settings settings{ lowWidth, highWidth, rotationRadians, wetMix, monoBelowHz };
+		if (settings == lastSettings) return;
+		lastSettings = settings;
+
+		const float cosTheta = std::cos(rotationRadians);
+		const float sinTheta = std::sin(rotationRadians);
+		const float dryMix = 1.0f - wetMix;
+		identity = true;
+
+		for (size_t binIdx = 0; binIdx < binPosition.size(); binIdx++) {
+			float matrix[numEntries];
+
+			if (binIdx * binFrequency < monoBelowHz) {
+				matrix[leftFromLeft] = matrix[leftFromRight] = matrix[rightFromLeft] = matrix[rightFromRight] = 0.5f;
+			}
+			else {
+				const float width = lowWidth + (highWidth - lowWidth) * binPosition[binIdx];
+				const float f1 = (1 + width) * 0.5f;
+				const float f2 = (1 - width) * 0.5f;
+
+				matrix[leftFromLeft] = f1 * cosTheta - f2 * sinTheta;
+				matrix[leftFromRight] = f2 * cosTheta - f1 * sinTheta;
+				matrix[rightFromLeft] = f1 * sinTheta + f2 * cosTheta;
+				matrix[rightFromRight] = f2 * sinTheta + f1 * cosTheta;
+			}
+
+			// Blend with the identity, so bypass keeps the same latency
+			matrix[leftFromLeft] = wetMix * matrix[leftFromLeft] + dryMix;
+			matrix[leftFromRight] *= wetMix;
+			matrix[rightFromLeft] *= wetMix;
+			matrix[rightFromRight] = wetMix * matrix[rightFromRight] + dryMix;
+
+			identity = identity && matrix[leftFromLeft] == 1.0f && matrix[leftFromRight] == 0.0f
+				&& matrix[rightFromLeft] == 0.0f && matrix[rightFromRight] == 1.0f;
+
+			for (int entry = 0; entry < numEntries; entry++) {
+				entries[entry][2 * binIdx] = matrix[entry];
+				entries[entry][2 * binIdx + 1] = matrix[entry];
+			}
+		}
+	}
+
+	bool isIdentity() const { return identity; }
+	int getNumValues() const { return numValues; }
+	const float* getEntry(Entry entry) const { return entries[entry].data(); }
+
+private:
+	//==============================================================================
+	static constexpr float MIN_FREQUENCY = 20.0f;
+	static constexpr float MAX_FREQUENCY = 20000.0f;
+
+	struct Settings {
+		float lowWidth = -1, highWidth = -1, rotationRadians = 0, wetMix = -1, monoBelowHz = 0;
+
+		bool operator==(const Settings& other) const {
+			return lowWidth == other.lowWidth && highWidth == other.highWidth && rotationRadians == other.rotationRadians
+				&& wetMix == other.wetMix && monoBelowHz == other.monoBelowHz;
+		}
+	};
+
+	std::vector<float> binPosition;
+	std::vector<float> entries[numEntries];
+	int numValues = 0;
+	float binFrequency = 0.0f;
+	Settings lastSettings;
+	bool identity = false;
+};
+
+//==============================================================================
+/**
+	Overlap-add STFT of one stereo pair with a Hann window on analysis and synthesis at 75 %
+	overlap (Hann squared sums to 1.5 over four hops, hence the 1 / 1.5 synthesis gain).
+
+	Samples are collected hop by hop and every full hop runs one frame, so the output is exactly
+	getLatencySamples() behind the input for any host block size. All buffers are allocated in
+	prepare(). juce::dsp::FFT is single precision, so the double path converts at the frame edges.
+*/
+template <typename T>
+class SpectralWidthEngine {
+public:
+	//==============================================================================
+	// Longer frames at high sample rates keep the frequency resolution of the width curve
+	static int getFFTOrderForSampleRate(double sampleRate) {
+		return sampleRate > 96000.0 ? 13 : sampleRate > 48000.0 ? 12 : 11;
+	}
+
+	void prepare(double sampleRate) {
+		const int order = getFFTOrderForSampleRate(sampleRate);
+		fftSize = 1 << order;
+		hopSize = fftSize / NUM_OVERLAPS;
+		fft = std::make_unique<juce::dsp::FFT>(order);
+
+		window.resize(static_cast<size_t>(fftSize));
+		synthesisWindow.resize(static_cast<size_t>(fftSize));
+		for (int sampleIdx = 0; sampleIdx < fftSize; sampleIdx++) {
+			// Periodic Hann, which overlaps to a constant
+			const float value = 0.5f - 0.5f * std::cos(juce::MathConstants<float>::twoPi * sampleIdx / fftSize);
+			window[static_cast<size_t>(sampleIdx)] = value;
+			synthesisWindow[static_cast<size_t>(sampleIdx)] = value / OVERLAP_GAIN;
+		}
+
+		inputFifo.setSize(NUM_CHANNELS, fftSize);
+		outputAccumulator.setSize(NUM_CHANNELS, fftSize);
+		frames.setSize(NUM_CHANNELS, 2 * fftSize);
+		reset();
+	}
+
+	void reset() {
+		inputFifo.clear();
+		outputAccumulator.clear();
+		hopPosition = 0;
+	}
+
+	int getLatencySamples() const { return fftSize; }
+
+	// Stands in for numSamples of silence once every buffer has decayed, so the frame grid stays where
+	// processing would have left it and resuming gives the same output
+	void skip(int numSamples) {
+		hopPosition = (hopPosition + numSamples) % hopSize;
+	}
+
+	//==============================================================================
+	void process(T* leftPtr, T* rightPtr, int numSamples, const SpectralMatrix& matrix) {
+		T* channels[NUM_CHANNELS] = { leftPtr, rightPtr };
+		const int inputOffset = fftSize - hopSize;
+
+		for (int doneSamples = 0; doneSamples < numSamples;) {
+			const int numToCopy = juce::jmin(numSamples - doneSamples, hopSize - hopPosition);
+
+			for (int channel = 0; channel < NUM_CHANNELS; channel++) {
+				auto* ioPtr = channels[channel] + doneSamples;
+				juce::FloatVectorOperations::copy(inputFifo.getWritePointer(channel, inputOffset + hopPosition), ioPtr, numToCopy);
+				juce::FloatVectorOperations::copy(ioPtr, outputAccumulator.getReadPointer(channel, hopPosition), numToCopy);
+			}
+
+			hopPosition += numToCopy;
+			doneSamples += numToCopy;
+
+			if (hopPosition == hopSize) {
+				processFrame(matrix);
+				hopPosition = 0;
+			}
+		}
+	}
+
+private:
+	//==============================================================================
+	static constexpr int NUM_CHANNELS = 2;
+	static constexpr int NUM_OVERLAPS = 4;
+	static constexpr float OVERLAP_GAIN = 1.5f;
+
+	std::unique_ptr<juce::dsp::FFT> fft;
+	int fftSize = 0;
+	int hopSize = 0;
+	int hopPosition = 0;
+
+	std::vector<float> window;
+	std::vector<float> synthesisWindow;
+	juce::AudioBuffer<T> inputFifo;				// the last fftSize input samples, newest hop at the end
+	juce::AudioBuffer<T> outputAccumulator;		// overlap-add sums, the first hop is complete
+	juce::AudioBuffer<float> frames;			// 2 * fftSize as juce::dsp::FFT requires
+
+	void processFrame(const SpectralMatrix& matrix) {
+		for (int channel = 0; channel < NUM_CHANNELS; channel++) {
+			const auto* input = inputFifo.getReadPointer(channel);
+			auto* frame = frames.getWritePointer(channel);
+
+			for (int sampleIdx = 0; sampleIdx < fftSize; sampleIdx++)
+				frame[sampleIdx] = static_cast<float>(input[sampleIdx]) * window[static_cast<size_t>(sampleIdx)];
+		}
+
+		// An identity matrix gives back the windowed frame, so only the windowing is needed
+		if (!matrix.isIdentity()) {
+			auto* leftFrame = frames.getWritePointer(0);
+			auto* rightFrame = frames.getWritePointer(1);
+
+			fft->performRealOnlyForwardTransform(leftFrame, true);
+			fft->performRealOnlyForwardTransform(rightFrame, true);
+			applyMatrix(leftFrame, rightFrame, matrix);
+			fft->performRealOnlyInverseTransform(leftFrame);
+			fft->performRealOnlyInverseTransform(rightFrame);
+		}
+
+		for (int channel = 0; channel < NUM_CHANNELS; channel++) {
+			auto* accumulator = outputAccumulator.getWritePointer(channel);
+			auto* fifo = inputFifo.getWritePointer(channel);
+			const auto* frame = frames.getReadPointer(channel);
+
+			// Drop the hop that was just played and add the new frame over the remaining overlap
+			std::memmove(accumulator, accumulator + hopSize, sizeof(T) * static_cast<size_t>(fftSize - hopSize));
+			std::fill(accumulator + fftSize - hopSize, accumulator + fftSize, T());
+
+			for (int sampleIdx = 0; sampleIdx < fftSize; sampleIdx++)
+				accumulator[sampleIdx] += static_cast<T>(frame[sampleIdx] * synthesisWindow[static_cast<size_t>(sampleIdx)]);
+
+			std::memmove(fifo, fifo + hopSize, sizeof(T) * static_cast<size_t>(fftSize - hopSize));
+		}
+	}
+
+	// Real matrix on complex bins: real and imaginary parts get the same weights, so the
+	// interleaved spectrum is processed as one flat array of floats
+	static void applyMatrix(float* leftFrame, float* rightFrame, const SpectralMatrix& matrix) noexcept {
+		using namespace StereoMatrixKernel;
+		constexpr int width = static_cast<int>(Vec<float>::size());
+
+		const auto* leftFromLeft = matrix.getEntry(SpectralMatrix::leftFromLeft);
+		const auto* leftFromRight = matrix.getEntry(SpectralMatrix::leftFromRight);
+		const auto* rightFromLeft = matrix.getEntry(SpectralMatrix::rightFromLeft);
+		const auto* rightFromRight = matrix.getEntry(SpectralMatrix::rightFromRight);
+
+		for (int valueIdx = 0; valueIdx < matrix.getNumValues(); valueIdx += width) {
+			const auto left = load(leftFrame + valueIdx);
+			const auto right = load(rightFrame + valueIdx);
+
+			store(leftFrame + valueIdx, load(leftFromLeft + valueIdx) * left + load(leftFromRight + valueIdx) * right);
+			store(rightFrame + valueIdx, load(rightFromLeft + valueIdx) * left + load(rightFromRight + valueIdx) * right);
+		}
+	}
+
+	//==============================================================================
+	JUCE_LEAK_DETECTOR(SpectralWidthEngine)
+};
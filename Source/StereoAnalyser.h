@@ -0,0 +1,190 @@
+/*
+  ==============================================================================
+
+	Correlation, balance and goniometer analysis of the main output pair,
+	computed off the audio thread.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// One published analysis frame; points are interleaved (side, mid) goniometer coordinates
+struct StereoAnalysisSnapshot {
+	float correlation = 0.0f;
+	float balance = 0.0f;
+	std::vector<float> points;
+	juce::uint32 sequence = 0;
+};
+
+//==============================================================================
+/**
+	The audio thread only pushes decimated L/R frames into a single-producer single-consumer
+	juce::AbstractFifo, which never blocks or allocates and drops frames when the reader falls
+	behind. A background thread drains the FIFO, updates exponentially weighted sums for the
+	correlation and balance, keeps the newest frames as the goniometer point cloud and publishes
+	a snapshot for the editor. Pushing is a no-op while no editor is listening.
+*/
+class StereoAnalyser : private juce::Thread {
+public:
+	StereoAnalyser() : juce::Thread("LPanner Analysis") {
+		leftFrames.resize(FIFO_SIZE);
+		rightFrames.resize(FIFO_SIZE);
+		points.resize(2 * NUM_POINTS);
+		published.points.resize(2 * NUM_POINTS);
+	}
+
+	~StereoAnalyser() override {
+		stop();
+	}
+
+	//==============================================================================
+	// Called from prepareToPlay; the reader picks the new rate up on its next pass
+	void prepare(double sampleRate) {
+		const int step = juce::jmax(1, juce::roundToInt(sampleRate / TARGET_FRAME_RATE));
+		decimation = step;
+		frameRate = static_cast<float>(sampleRate / step);
+	}
+
+	// Audio thread: one FIFO write per block, every decimation-th frame
+	template <typename T>
+	void push(const T* leftPtr, const T* rightPtr, int numSamples) noexcept {
+		if (!active.load(std::memory_order_relaxed)) return;
+
+		const int step = decimation.load(std::memory_order_relaxed);
+		if (phase >= numSamples) {
+			phase -= numSamples;
+			return;
+		}
+
+		const int numFrames = (numSamples - phase + step - 1) / step;
+		const auto scope = fifo.write(numFrames);
+		int sampleIdx = phase;
+
+		const auto copyFrames = [&](int start, int size) {
+			for (int frameIdx = start; frameIdx < start + size; frameIdx++, sampleIdx += step) {
+				leftFrames[static_cast<size_t>(frameIdx)] = static_cast<float>(leftPtr[sampleIdx]);
+				rightFrames[static_cast<size_t>(frameIdx)] = static_cast<float>(rightPtr[sampleIdx]);
+			}
+		};
+		copyFrames(scope.startIndex1, scope.blockSize1);
+		copyFrames(scope.startIndex2, scope.blockSize2);
+
+		// Frames that did not fit are dropped, the decimation grid stays intact
+		phase = phase + numFrames * step - numSamples;
+	}
+
+	//==============================================================================
+	// Message thread: the editor runs the analysis only while it is open
+	void start() {
+		active = true;
+		startThread(juce::Thread::Priority::low);
+	}
+
+	void stop() {
+		active = false;
+		stopThread(ANALYSIS_INTERVAL_MS * 10);
+	}
+
+	// Copies the newest snapshot if it is newer than lastSequence
+	bool getSnapshot(StereoAnalysisSnapshot& snapshot, juce::uint32 lastSequence) const {
+		const juce::SpinLock::ScopedLockType lock(publishLock);
+		if (published.sequence == lastSequence) return false;
+
+		snapshot.correlation = published.correlation;
+		snapshot.balance = published.balance;
+		snapshot.points = published.points;
+		snapshot.sequence = published.sequence;
+		return true;
+	}
+
+private:
+	//==============================================================================
+	static constexpr int FIFO_SIZE = 16384;
+	static constexpr int NUM_POINTS = 512;
+	static constexpr int ANALYSIS_INTERVAL_MS = 15;
+	static constexpr double TARGET_FRAME_RATE = 8000.0;
+	static constexpr float INTEGRATION_TIME_SECS = 0.3f;
+
+	struct CorrelationSums {
+		float leftRight = 0.0f;
+		float leftLeft = 0.0f;
+		float rightRight = 0.0f;
+	};
+
+	// Shared between the audio thread (writer) and the analysis thread (reader)
+	juce::AbstractFifo fifo{ FIFO_SIZE };
+	std::vector<float> leftFrames;
+	std::vector<float> rightFrames;
+	std::atomic<bool> active{ false };
+	std::atomic<int> decimation{ 1 };
+	std::atomic<float> frameRate{ 8000.0f };
+
+	// Audio thread only
+	int phase = 0;
+
+	// Analysis thread only
+	CorrelationSums correlationSums;
+	std::vector<float> points;
+	int nextPoint = 0;
+
+	// Analysis thread writes, message thread reads
+	mutable juce::SpinLock publishLock;
+	StereoAnalysisSnapshot published;
+
+	void run() override {
+		// Frames left over from the last session are stale; the audio thread keeps owning the write side
+		fifo.read(fifo.getNumReady());
+		correlationSums = {};
+
+		while (!threadShouldExit()) {
+			wait(ANALYSIS_INTERVAL_MS);
+
+			const auto scope = fifo.read(fifo.getNumReady());
+			if (scope.blockSize1 + scope.blockSize2 == 0) continue;
+
+			analyse(scope.startIndex1, scope.blockSize1);
+			analyse(scope.startIndex2, scope.blockSize2);
+			publish();
+		}
+	}
+
+	void analyse(int start, int size) {
+		const float decay = std::exp(-1.0f / (INTEGRATION_TIME_SECS * frameRate.load()));
+		constexpr float diagonal = juce::MathConstants<float>::sqrt2 * 0.5f;
+
+		for (int frameIdx = start; frameIdx < start + size; frameIdx++) {
+			const float left = leftFrames[static_cast<size_t>(frameIdx)];
+			const float right = rightFrames[static_cast<size_t>(frameIdx)];
+
+			correlationSums.leftRight = decay * correlationSums.leftRight + left * right;
+			correlationSums.leftLeft = decay * correlationSums.leftLeft + left * left;
+			correlationSums.rightRight = decay * correlationSums.rightRight + right * right;
+
+			// Rotated by 45 degrees: mono is vertical, left-only leans to the left
+			points[static_cast<size_t>(2 * nextPoint)] = (right - left) * diagonal;
+			points[static_cast<size_t>(2 * nextPoint + 1)] = (left + right) * diagonal;
+			nextPoint = (nextPoint + 1) % NUM_POINTS;
+		}
+	}
+
+	void publish() {
+		constexpr float silence = 1.0e-9f;
+		const float energy = correlationSums.leftLeft * correlationSums.rightRight;
+		const float leftLevel = std::sqrt(correlationSums.leftLeft);
+		const float rightLevel = std::sqrt(correlationSums.rightRight);
+
+		const juce::SpinLock::ScopedLockType lock(publishLock);
+
+		// Silence reads as neutral rather than uncorrelated
+		published.correlation = energy > silence ? correlationSums.leftRight / std::sqrt(energy) : 1.0f;
+		published.balance = leftLevel + rightLevel > silence ? (rightLevel - leftLevel) / (leftLevel + rightLevel) : 0.0f;
+		published.points = points;
+		published.sequence++;
+	}
+
+	//==============================================================================
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(StereoAnalyser)
+};
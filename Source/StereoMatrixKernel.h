@@ -0,0 +1,246 @@
+/*
+  ==============================================================================
+
+	Vectorized stereo matrix used by LPannerAudioProcessor::processBlockImpl.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+namespace StereoMatrixKernel {
+	template <typename T>
+	using Vec = juce::dsp::SIMDRegister<T>;
+
+	// Which part of the matrix a chunk needs, picked once per chunk from the smoother states
+	enum class Mode {
+		classic,	// stereoMix == 0, fully wet: 2x2 matrix only
+		modern,		// stereoMix == 1, fully wet: rotation plus delayed mid
+		crossfade,	// stereoMix ramping, fully wet: both outputs blended
+		bypassRamp	// wetMix ramping or partly dry: full blend with the dry input
+	};
+
+	enum Coefficient {
+		leftClassicCoefficient1,
+		leftClassicCoefficient2,
+		rightClassicCoefficient1,
+		rightClassicCoefficient2,
+		cosTheta,
+		sinTheta,
+		leftModernCoefficient,
+		rightModernCoefficient,
+		wetMix,
+		stereoMix,
+		numCoefficients
+	};
+
+	// Host buffers carry no alignment guarantee, so go through memcpy (compiles to unaligned loads/stores)
+	template <typename T>
+	inline Vec<T> load(const T* src) noexcept {
+		Vec<T> v;
+		std::memcpy(&v.value, src, sizeof(v.value));
+		return v;
+	}
+
+	template <typename T>
+	inline void store(T* dst, Vec<T> v) noexcept {
+		std::memcpy(dst, &v.value, sizeof(v.value));
+	}
+
+	template <typename V>
+	struct ElementType { using Type = V; };
+
+	template <typename T>
+	struct ElementType<Vec<T>> { using Type = T; };
+
+	// Coefficients that stay constant across the chunk
+	template <typename T>
+	struct StaticCoefficients {
+		T values[numCoefficients];
+
+		Vec<T> vector(Coefficient k, int) const noexcept { return Vec<T>::expand(values[k]); }
+		T scalar(Coefficient k, int) const noexcept { return values[k]; }
+	};
+
+	// Per-sample coefficients read from the ramp buffer
+	template <typename T>
+	struct RampedCoefficients {
+		const T* ramps[numCoefficients];
+
+		Vec<T> vector(Coefficient k, int sampleIdx) const noexcept { return load(ramps[k] + sampleIdx); }
+		T scalar(Coefficient k, int sampleIdx) const noexcept { return ramps[k][sampleIdx]; }
+	};
+
+	// Crossover output and delayed mid for one vector's worth of samples: the matrix runs on the
+	// high bands and the mono low band is added back
+	template <typename T>
+	struct SplitBands {
+		static constexpr int size = static_cast<int>(Vec<T>::size());
+
+		T highLeft[size];
+		T highRight[size];
+		T low[size];
+		T midDelay[size];
+	};
+
+	// Classic and modern outputs mixed by stereoMix, then blended with the dry input by wetMix.
+	// Each mode only evaluates the terms that are not constant 0 or 1 for it. Works on both registers
+	// and scalars, so the vector body and the scalar tail share one formula.
+	// left/right hold the dry input; without split bands highLeft/highRight are the same values.
+	template <Mode mode, bool splitBands, typename V, typename Coefficients>
+	inline void applyMatrix(V& left, V& right, V highLeft, V highRight, V midDelaySignal, V lowSignal, const Coefficients& c, int sampleIdx) noexcept {
+		using Value = typename ElementType<V>::Type;
+
+		const auto get = [&c, sampleIdx](Coefficient k) {
+			if constexpr (std::is_arithmetic_v<V>) return c.scalar(k, sampleIdx);
+			else return c.vector(k, sampleIdx);
+		};
+
+		V leftOutput, rightOutput;
+
+		if constexpr (mode == Mode::classic) {
+			juce::ignoreUnused(midDelaySignal);
+
+			leftOutput = get(leftClassicCoefficient1) * highLeft + get(leftClassicCoefficient2) * highRight;
+			rightOutput = get(rightClassicCoefficient1) * highLeft + get(rightClassicCoefficient2) * highRight;
+		}
+		else if constexpr (mode == Mode::modern) {
+			leftOutput = highLeft * get(cosTheta) - highRight * get(sinTheta) + get(leftModernCoefficient) * midDelaySignal;
+			rightOutput = highLeft * get(sinTheta) + highRight * get(cosTheta) + get(rightModernCoefficient) * midDelaySignal;
+		}
+		else {
+			const V mix = get(stereoMix);
+			const V classic = V(static_cast<Value>(1)) - mix;
+
+			const V leftClassic = get(leftClassicCoefficient1) * highLeft + get(leftClassicCoefficient2) * highRight;
+			const V rightClassic = get(rightClassicCoefficient1) * highLeft + get(rightClassicCoefficient2) * highRight;
+			const V leftModern = highLeft * get(cosTheta) - highRight * get(sinTheta) + get(leftModernCoefficient) * midDelaySignal;
+			const V rightModern = highLeft * get(sinTheta) + highRight * get(cosTheta) + get(rightModernCoefficient) * midDelaySignal;
+
+			leftOutput = classic * leftClassic + mix * leftModern;
+			rightOutput = classic * rightClassic + mix * rightModern;
+		}
+
+		if constexpr (splitBands) {
+			leftOutput = leftOutput + lowSignal;
+			rightOutput = rightOutput + lowSignal;
+		}
+		else {
+			juce::ignoreUnused(lowSignal);
+		}
+
+		if constexpr (mode == Mode::bypassRamp) {
+			const V wet = get(wetMix);
+			const V dry = V(static_cast<Value>(1)) - wet;
+
+			leftOutput = dry * left + wet * leftOutput;
+			rightOutput = dry * right + wet * rightOutput;
+		}
+
+		left = leftOutput;
+		right = rightOutput;
+	}
+
+	// Processes Vec<T>::size() samples per iteration (4/8 floats or 2/4 doubles) plus a scalar tail.
+	// midDelayPtr is not read in classic mode and may be null there.
+	template <Mode mode, typename T, typename Coefficients>
+	void processChunk(T* leftPtr, T* rightPtr, const T* midDelayPtr, int numSamples, const Coefficients& coefficients) noexcept {
+		constexpr int width = static_cast<int>(Vec<T>::size());
+		constexpr bool readsDelay = mode != Mode::classic;
+		int sampleIdx = 0;
+
+		for (; sampleIdx + width <= numSamples; sampleIdx += width) {
+			auto left = load(leftPtr + sampleIdx);
+			auto right = load(rightPtr + sampleIdx);
+			const auto midDelaySignal = readsDelay ? load(midDelayPtr + sampleIdx) : Vec<T>();
+
+			applyMatrix<mode, false>(left, right, left, right, midDelaySignal, Vec<T>(), coefficients, sampleIdx);
+
+			store(leftPtr + sampleIdx, left);
+			store(rightPtr + sampleIdx, right);
+		}
+
+		for (; sampleIdx < numSamples; sampleIdx++) {
+			const T midDelaySignal = readsDelay ? midDelayPtr[sampleIdx] : T();
+			T& left = leftPtr[sampleIdx];
+			T& right = rightPtr[sampleIdx];
+
+			applyMatrix<mode, false>(left, right, left, right, midDelaySignal, T(), coefficients, sampleIdx);
+		}
+	}
+
+	// With the crossover, bandSource(sampleIdx, numSamples, bands) fills the bands and the delayed mid of
+	// one vector right before the matrix reads them, so the chunk is traversed once and the bands never
+	// leave the stack. The source reads the input at sampleIdx, which is only overwritten afterwards.
+	template <Mode mode, typename T, typename BandSource, typename Coefficients>
+	void processSplitChunk(T* leftPtr, T* rightPtr, BandSource& bandSource, int numSamples, const Coefficients& coefficients) noexcept {
+		constexpr int width = SplitBands<T>::size;
+		constexpr bool readsDelay = mode != Mode::classic;
+		SplitBands<T> bands;
+		int sampleIdx = 0;
+
+		for (; sampleIdx + width <= numSamples; sampleIdx += width) {
+			bandSource(sampleIdx, width, bands);
+
+			auto left = load(leftPtr + sampleIdx);
+			auto right = load(rightPtr + sampleIdx);
+			const auto midDelaySignal = readsDelay ? load(bands.midDelay) : Vec<T>();
+
+			applyMatrix<mode, true>(left, right, load(bands.highLeft), load(bands.highRight), midDelaySignal, load(bands.low), coefficients, sampleIdx);
+
+			store(leftPtr + sampleIdx, left);
+			store(rightPtr + sampleIdx, right);
+		}
+
+		const int tailSize = numSamples - sampleIdx;
+		if (tailSize > 0)
+			bandSource(sampleIdx, tailSize, bands);
+
+		for (int bandIdx = 0; bandIdx < tailSize; bandIdx++, sampleIdx++) {
+			const T midDelaySignal = readsDelay ? bands.midDelay[bandIdx] : T();
+			T& left = leftPtr[sampleIdx];
+			T& right = rightPtr[sampleIdx];
+
+			applyMatrix<mode, true>(left, right, bands.highLeft[bandIdx], bands.highRight[bandIdx], midDelaySignal, bands.low[bandIdx], coefficients, sampleIdx);
+		}
+	}
+
+	// Dispatches to the specialization for the chunk's mode
+	template <typename T, typename Coefficients>
+	void process(Mode mode, T* leftPtr, T* rightPtr, const T* midDelayPtr, int numSamples, const Coefficients& coefficients) noexcept {
+		switch (mode) {
+		case Mode::classic:
+			processChunk<Mode::classic>(leftPtr, rightPtr, midDelayPtr, numSamples, coefficients);
+			break;
+		case Mode::modern:
+			processChunk<Mode::modern>(leftPtr, rightPtr, midDelayPtr, numSamples, coefficients);
+			break;
+		case Mode::crossfade:
+			processChunk<Mode::crossfade>(leftPtr, rightPtr, midDelayPtr, numSamples, coefficients);
+			break;
+		case Mode::bypassRamp:
+			processChunk<Mode::bypassRamp>(leftPtr, rightPtr, midDelayPtr, numSamples, coefficients);
+			break;
+		}
+	}
+
+	template <typename T, typename BandSource, typename Coefficients>
+	void processSplit(Mode mode, T* leftPtr, T* rightPtr, BandSource& bandSource, int numSamples, const Coefficients& coefficients) noexcept {
+		switch (mode) {
+		case Mode::classic:
+			processSplitChunk<Mode::classic>(leftPtr, rightPtr, bandSource, numSamples, coefficients);
+			break;
+		case Mode::modern:
+			processSplitChunk<Mode::modern>(leftPtr, rightPtr, bandSource, numSamples, coefficients);
+			break;
+		case Mode::crossfade:
+			processSplitChunk<Mode::crossfade>(leftPtr, rightPtr, bandSource, numSamples, coefficients);
+			break;
+		case Mode::bypassRamp:
+			processSplitChunk<Mode::bypassRamp>(leftPtr, rightPtr, bandSource, numSamples, coefficients);
+			break;
+		}
+	}
+}
@@ -0,0 +1,87 @@
+/*
+  ==============================================================================
+
+	Decompressed WebView assets, shared by every editor in the process.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+	Held through juce::SharedResourcePointer, so all plugin instances share one cache. The
+	first lookup inflates every entry of BinaryData::assets_zip and resolves its MIME type; from
+	then on the map is immutable and lookups from any thread need no locking.
+*/
+class WebAssetCache {
+public:
+	struct Asset {
+		std::vector<std::byte> data;
+		const char* mimeType = "";
+	};
+
+	// path is relative to the archive root, e.g. "index.html" or "assets/index.js"
+	const Asset* find(const juce::String& path) {
+		std::call_once(built, [this] { build(); });
+
+		if (const auto it = assets.find(path); it != assets.end())
+			return &it->second;
+		return nullptr;
+	}
+
+private:
+	std::once_flag built;
+	std::unordered_map<juce::String, Asset> assets;
+
+	void build() {
+		// Reads the embedded archive in place instead of copying it into a MemoryBlock
+		juce::MemoryInputStream zipStream(BinaryData::assets_zip, static_cast<size_t>(BinaryData::assets_zipSize), false);
+		juce::ZipFile archive(zipStream);
+
+		for (int entryIdx = 0; entryIdx < archive.getNumEntries(); entryIdx++) {
+			const auto* entry = archive.getEntry(entryIdx);
+			if (entry == nullptr || entry->filename.endsWithChar('/')) continue;
+
+			const auto entryStream = rawToUniquePtr(archive.createStreamForEntry(entryIdx));
+			if (entryStream == nullptr) continue;
+
+			Asset asset;
+			asset.data.resize(static_cast<size_t>(entry->uncompressedSize));
+			entryStream->read(asset.data.data(), asset.data.size());
+			asset.mimeType = getMimeForExtension(entry->filename.fromLastOccurrenceOf(".", false, false).toLowerCase());
+
+			assets.emplace(entry->filename, std::move(asset));
+		}
+	}
+
+	static const char* getMimeForExtension(const juce::String& extension) {
+		static const std::unordered_map<juce::String, const char*> mimeMap = {
+			{{"htm"}, "text/html"},
+			{{"html"}, "text/html"},
+			{{"txt"}, "text/plane"},
+			{{"css"}, "text/css"},
+			{{"js"}, "application/javascript"},
+			{{"json"}, "application/json"},
+			{{"map"}, "application/json"},
+			{{"png"}, "image/png"},
+			{{"jpg"}, "image/jpeg"},
+			{{"jpeg"}, "image/jpeg"},
+			{{"ico"}, "image/vnd.microsoft.icon"},
+			{{"gif"}, "image/gif"},
+			{{"svg"}, "image/svg+xml"},
+			{{"woff"}, "font/woff"},
+			{{"woff2"}, "font/woff2"}
+		};
+
+		if (const auto it = mimeMap.find(extension);
+			it != mimeMap.end())
+			return it->second;
+
+		// Every entry is resolved up front, so stray files in the archive must not assert
+		DBG("No MIME type for ." << extension);
+		return "application/octet-stream";
+	}
+};
@@ -0,0 +1,133 @@
+/*
+  ==============================================================================
+
+	Batched parameter traffic between the processor and the WebView page.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+	Replaces one JUCE web relay and attachment per control. Host-side changes, including
+	automation, only set a dirty flag from whatever thread they arrive on; the editor calls
+	collectChanges() once per frame and sends everything that changed as one event. Changes
+	from the page are applied as they arrive, so dragging stays immediate, and wrapped in change
+	gestures so a drag is one undo step in the host.
+
+	Values cross the bridge normalised; choices go to the page once, with the initial values.
+*/
+class WebParameterBridge : private juce::AudioProcessorParameter::Listener {
+public:
+	WebParameterBridge(juce::AudioProcessorValueTreeState& state, const juce::StringArray& parameterIDs)
+		: entries(static_cast<size_t>(parameterIDs.size())) {
+		for (int entryIdx = 0; entryIdx < parameterIDs.size(); entryIdx++) {
+			auto* parameter = state.getParameter(parameterIDs[entryIdx]);
+			jassert(parameter != nullptr);
+
+			entries[static_cast<size_t>(entryIdx)].parameter = parameter;
+			parameter->addListener(this);
+		}
+	}
+
+	~WebParameterBridge() override {
+		for (auto& entry : entries) {
+			entry.parameter->removeListener(this);
+			if (entry.inGesture) entry.parameter->endChangeGesture();
+		}
+	}
+
+	//==============================================================================
+	// Message thread: identifiers, current values and choices, for the page's initial state
+	juce::var getParameterInfo() const {
+		juce::Array<juce::var> infos;
+
+		for (const auto& entry : entries) {
+			auto* info = new juce::DynamicObject();
+			info->setProperty("id", entry.parameter->getParameterID());
+			info->setProperty("value", entry.parameter->getValue());
+
+			if (auto* choice = dynamic_cast<juce::AudioParameterChoice*>(entry.parameter)) {
+				juce::Array<juce::var> choices;
+				for (const auto& name : choice->choices) choices.add(name);
+				info->setProperty("choices", choices);
+			}
+
+			infos.add(juce::var(info));
+		}
+		return infos;
+	}
+
+	// Message thread: everything that changed since the last call as { id: value }, or a void var
+	juce::var collectChanges() {
+		if (!anyDirty.exchange(false)) return {};
+
+		auto* changes = new juce::DynamicObject();
+		for (auto& entry : entries) {
+			if (entry.dirty.exchange(false))
+				changes->setProperty(entry.parameter->getParameterID(), entry.parameter->getValue());
+		}
+		return juce::var(changes);
+	}
+
+	//==============================================================================
+	// Page events: { id, value } and { id, begin }
+	void handleSetParameter(const juce::var& payload) {
+		auto* entry = findEntry(payload["id"].toString());
+		if (entry == nullptr) return;
+
+		// A value outside a gesture (a click, a typed value) is a gesture of its own
+		const float value = juce::jlimit(0.0f, 1.0f, static_cast<float>(payload["value"]));
+		if (!entry->inGesture) entry->parameter->beginChangeGesture();
+		entry->parameter->setValueNotifyingHost(value);
+		if (!entry->inGesture) entry->parameter->endChangeGesture();
+	}
+
+	void handleGesture(const juce::var& payload) {
+		auto* entry = findEntry(payload["id"].toString());
+		if (entry == nullptr) return;
+
+		const bool begin = payload["begin"];
+		if (begin == entry->inGesture) return;
+
+		entry->inGesture = begin;
+		if (begin) entry->parameter->beginChangeGesture();
+		else entry->parameter->endChangeGesture();
+	}
+
+private:
+	struct Entry {
+		juce::RangedAudioParameter* parameter = nullptr;
+		std::atomic<bool> dirty{ false };
+		bool inGesture = false;		// message thread only
+	};
+
+	// Sized once in the constructor; Entry holds an atomic and never moves
+	std::vector<Entry> entries;
+	std::atomic<bool> anyDirty{ false };
+
+	Entry* findEntry(const juce::String& parameterID) {
+		for (auto& entry : entries)
+			if (entry.parameter->getParameterID() == parameterID) return &entry;
+		return nullptr;
+	}
+
+	// Any thread, often the audio thread: only flags, never touches the page
+	void parameterValueChanged(int parameterIndex, float) override {
+		for (auto& entry : entries) {
+			if (entry.parameter->getParameterIndex() == parameterIndex) {
+				entry.dirty.store(true);
+				anyDirty.store(true);
+				return;
+			}
+		}
+	}
+
+	void parameterGestureChanged(int, bool) override {}
+
+	//==============================================================================
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WebParameterBridge)
+};
@@ -0,0 +1,466 @@
+/*
+  ==============================================================================
+
+	Offline batch renderer for LPannerAudioProcessor.
+
+	Renders many files in parallel: every worker of a thread pool owns one
+	processor and pulls the next file from a shared queue. Audio is streamed
+	in fixed-size blocks, so memory use does not depend on file length.
+	Every input becomes <output-dir>/<name>.wav; inputs that would share an
+	output name are rejected before anything is rendered.
+
+	Usage:
+	  LPannerRender [options] <files...>
+
+	  --list=<file>         text file with one input path per line
+	  --output-dir=<dir>    where the rendered WAV files go (required)
+	  --preset=<file>       plugin state XML (<PARAMETERS><PARAM id=".." value=".."/>)
+	                        or a binary state chunk as saved by the plugin ("LPst")
+	  --set=<id>=<value>    parameter value in plain units, e.g. --set=stereo=150
+	  --automation=<file>   CSV breakpoints "seconds,parameterID,value", linear in between;
+	                        stereoMode cannot be automated, as it changes the latency
+	  --threads=<n>         number of workers (default: number of CPU cores)
+	  --block=<n>           block size in samples (default 512)
+	  --double              process in double precision
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+
+#include <cstdio>
+#include <map>
+
+namespace {
+	constexpr int DEFAULT_BLOCK_SIZE = 512;
+
+	//==============================================================================
+	// Breakpoint automation for one or more parameters, evaluated at block boundaries
+	class AutomationCurve {
+	public:
+		bool load(const juce::File& file, juce::String& error) {
+			juce::StringArray lines;
+			file.readLines(lines);
+
+			for (int lineIdx = 0; lineIdx < lines.size(); lineIdx++) {
+				const auto line = lines[lineIdx].trim();
+				if (line.isEmpty() || line.startsWithChar('#')) continue;
+
+				const auto fields = juce::StringArray::fromTokens(line, ",", "\"");
+				if (fields.size() != 3) {
+					error = file.getFileName() + ":" + juce::String(lineIdx + 1) + ": expected seconds,parameterID,value";
+					return false;
+				}
+
+				breakpoints[fields[1].trim()].push_back({ fields[0].getDoubleValue(), fields[2].getFloatValue() });
+			}
+
+			for (auto& [parameterID, points] : breakpoints)
+				std::stable_sort(points.begin(), points.end(), [](const Breakpoint& a, const Breakpoint& b) { return a.timeSecs < b.timeSecs; });
+
+			return true;
+		}
+
+		template <typename Callback>
+		void forEachValueAt(double timeSecs, Callback&& callback) const {
+			for (const auto& [parameterID, points] : breakpoints)
+				callback(parameterID, getValueAt(points, timeSecs));
+		}
+
+		template <typename Callback>
+		void forEachParameterID(Callback&& callback) const {
+			for (const auto& entry : breakpoints)
+				callback(entry.first);
+		}
+
+	private:
+		struct Breakpoint {
+			double timeSecs;
+			float value;
+		};
+
+		std::map<juce::String, std::vector<Breakpoint>> breakpoints;
+
+		// Held before the first and after the last breakpoint
+		static float getValueAt(const std::vector<Breakpoint>& points, double timeSecs) {
+			if (timeSecs <= points.front().timeSecs) return points.front().value;
+			if (timeSecs >= points.back().timeSecs) return points.back().value;
+
+			const auto next = std::upper_bound(points.begin(), points.end(), timeSecs,
+				[](double t, const Breakpoint& point) { return t < point.timeSecs; });
+			const auto previous = next - 1;
+			const double position = (timeSecs - previous->timeSecs) / (next->timeSecs - previous->timeSecs);
+
+			return static_cast<float>(previous->value + position * (next->value - previous->value));
+		}
+	};
+
+	//==============================================================================
+	struct RenderSettings {
+		juce::Array<juce::File> inputFiles;
+		juce::File outputDirectory;
+		std::map<juce::String, float> parameterValues;
+		AutomationCurve automation;
+		int numThreads = juce::SystemStats::getNumCpus();
+		int blockSize = DEFAULT_BLOCK_SIZE;
+		bool doublePrecision = false;
+	};
+
+	// Result of one file, filled in by the worker that rendered it
+	struct RenderResult {
+		double audioSecs = 0.0;
+		double renderSecs = 0.0;
+		juce::String error;
+	};
+
+	juce::File getOutputFile(const RenderSettings& settings, const juce::File& inputFile) {
+		return settings.outputDirectory.getChildFile(inputFile.getFileNameWithoutExtension() + ".wav");
+	}
+
+	bool setParameter(LPannerAudioProcessor& processor, const juce::String& parameterID, float value) {
+		auto* parameter = processor.parameters.getParameter(parameterID);
+		if (parameter == nullptr) return false;
+
+		parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+		return true;
+	}
+
+	//==============================================================================
+	/**
+		One thread pool job per worker. It owns its processor, so no state is shared between
+		files rendered in parallel, and keeps taking files until the queue is empty.
+	*/
+	class RenderWorker : public juce::ThreadPoolJob {
+	public:
+		RenderWorker(const RenderSettings& renderSettings, std::atomic<int>& nextFileIndex, std::vector<RenderResult>& renderResults)
+			: juce::ThreadPoolJob("LPanner render worker"), settings(renderSettings), nextFile(nextFileIndex), results(renderResults) {
+			formatManager.registerBasicFormats();
+		}
+
+		JobStatus runJob() override {
+			for (int fileIdx = nextFile++; fileIdx < settings.inputFiles.size() && !shouldExit(); fileIdx = nextFile++) {
+				const auto startMs = juce::Time::getMillisecondCounterHiRes();
+				auto& result = results[static_cast<size_t>(fileIdx)];
+
+				if (settings.doublePrecision)
+					renderFile<double>(settings.inputFiles[fileIdx], result);
+				else
+					renderFile<float>(settings.inputFiles[fileIdx], result);
+
+				result.renderSecs = (juce::Time::getMillisecondCounterHiRes() - startMs) * 0.001;
+				report(settings.inputFiles[fileIdx], result);
+			}
+
+			return jobHasFinished;
+		}
+
+	private:
+		const RenderSettings& settings;
+		std::atomic<int>& nextFile;
+		std::vector<RenderResult>& results;
+
+		juce::AudioFormatManager formatManager;
+		juce::WavAudioFormat wavFormat;
+		LPannerAudioProcessor processor;
+
+		static juce::CriticalSection& getOutputLock() {
+			static juce::CriticalSection lock;
+			return lock;
+		}
+
+		static void report(const juce::File& file, const RenderResult& result) {
+			const juce::ScopedLock lock(getOutputLock());
+
+			if (result.error.isNotEmpty())
+				std::fprintf(stderr, "FAILED  %s: %s\n", file.getFullPathName().toRawUTF8(), result.error.toRawUTF8());
+			else
+				std::printf("done    %s  %.1f s in %.2f s (%.0fx realtime)\n", file.getFileName().toRawUTF8(),
+					result.audioSecs, result.renderSecs, result.audioSecs / juce::jmax(result.renderSecs, 1.0e-9));
+
+			std::fflush(stdout);
+		}
+
+		void applyPreset() {
+			for (const auto& [parameterID, value] : settings.parameterValues)
+				setParameter(processor, parameterID, value);
+		}
+
+		template <typename T>
+		void renderFile(const juce::File& inputFile, RenderResult& result) {
+			std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(inputFile));
+			if (reader == nullptr) {
+				result.error = "cannot open as audio";
+				return;
+			}
+
+			// Mono sources are rendered as mono-to-stereo
+			const int numSourceChannels = static_cast<int>(reader->numChannels);
+			if (numSourceChannels < 1 || numSourceChannels > 2) {
+				result.error = "unsupported channel count " + juce::String(numSourceChannels);
+				return;
+			}
+
+			const auto outputFile = getOutputFile(settings, inputFile);
+			if (outputFile == inputFile) {
+				result.error = "output would overwrite the input";
+				return;
+			}
+
+			outputFile.deleteFile();
+			auto outputStream = outputFile.createOutputStream();
+			if (outputStream == nullptr) {
+				result.error = "cannot write " + outputFile.getFullPathName();
+				return;
+			}
+
+			const int bitsPerSample = reader->usesFloatingPointData ? 32 : juce::jlimit(16, 24, static_cast<int>(reader->bitsPerSample));
+			std::unique_ptr<juce::AudioFormatWriter> writer(wavFormat.createWriterFor(outputStream.get(), reader->sampleRate, 2, bitsPerSample, {}, 0));
+			if (writer == nullptr) {
+				result.error = "cannot create a WAV writer";
+				return;
+			}
+			outputStream.release();
+
+			// A fresh state per file: parameters, smoothers and the delay line start from the preset
+			const int blockSize = settings.blockSize;
+			const double sampleRate = reader->sampleRate;
+
+			processor.setNonRealtime(true);
+			processor.setProcessingPrecision(std::is_same_v<T, double> ? juce::AudioProcessor::doublePrecision : juce::AudioProcessor::singlePrecision);
+			processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+			applyPreset();
+			applyAutomation(0.0);
+			processor.prepareToPlay(sampleRate, blockSize);
+
+			// Input is padded with silence for the latency and the tail; the first latency samples are dropped
+			const juce::int64 inputLength = reader->lengthInSamples;
+			const juce::int64 latency = processor.getLatencySamples();
+			const juce::int64 tail = static_cast<juce::int64>(std::ceil(processor.getTailLengthSeconds() * sampleRate));
+			const juce::int64 totalLength = inputLength + latency + tail;
+
+			juce::AudioBuffer<float> fileBuffer(2, blockSize);
+			juce::AudioBuffer<T> processBuffer(2, blockSize);
+			juce::MidiBuffer midiMessages;
+
+			for (juce::int64 position = 0; position < totalLength; position += blockSize) {
+				const int numSamples = static_cast<int>(juce::jmin<juce::int64>(blockSize, totalLength - position));
+				const int numInputSamples = static_cast<int>(juce::jlimit<juce::int64>(0, numSamples, inputLength - position));
+
+				fileBuffer.clear();
+				if (numInputSamples > 0) {
+					reader->read(&fileBuffer, 0, numInputSamples, position, true, numSourceChannels > 1);
+					if (numSourceChannels == 1)
+						fileBuffer.copyFrom(1, 0, fileBuffer, 0, 0, numInputSamples);
+				}
+
+				applyAutomation(position / sampleRate);
+
+				juce::AudioBuffer<T> block(processBuffer.getArrayOfWritePointers(), 2, 0, numSamples);
+				for (int channel = 0; channel < 2; channel++)
+					for (int sampleIdx = 0; sampleIdx < numSamples; sampleIdx++)
+						block.setSample(channel, sampleIdx, static_cast<T>(fileBuffer.getSample(channel, sampleIdx)));
+
+				processor.processBlock(block, midiMessages);
+
+				for (int channel = 0; channel < 2; channel++)
+					for (int sampleIdx = 0; sampleIdx < numSamples; sampleIdx++)
+						fileBuffer.setSample(channel, sampleIdx, static_cast<float>(block.getSample(channel, sampleIdx)));
+
+				// Skip the part of the block that is still inside the latency
+				const int skip = static_cast<int>(juce::jlimit<juce::int64>(0, numSamples, latency - position));
+				if (skip < numSamples && !writer->writeFromAudioSampleBuffer(fileBuffer, skip, numSamples - skip)) {
+					result.error = "write failed";
+					break;
+				}
+			}
+
+			processor.releaseResources();
+
+			// Close the file before deleting it, so no truncated WAV is left behind
+			if (result.error.isNotEmpty()) {
+				writer.reset();
+				outputFile.deleteFile();
+				return;
+			}
+
+			result.audioSecs = inputLength / sampleRate;
+		}
+
+		void applyAutomation(double timeSecs) {
+			settings.automation.forEachValueAt(timeSecs, [this](const juce::String& parameterID, float value) {
+				setParameter(processor, parameterID, value);
+			});
+		}
+	};
+
+	//==============================================================================
+	// A binary chunk goes through the plugin's own state loader; anything else is read as XML
+	bool loadPreset(const juce::File& file, RenderSettings& settings, juce::String& error) {
+		juce::MemoryBlock data;
+		if (!file.loadFileAsData(data)) {
+			error = "cannot read preset " + file.getFullPathName();
+			return false;
+		}
+
+		if (BinaryState::isBinaryState(data.getData(), static_cast<int>(data.getSize()))) {
+			LPannerAudioProcessor processor;
+			processor.setStateInformation(data.getData(), static_cast<int>(data.getSize()));
+
+			for (auto* parameter : processor.getParameters())
+				if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter))
+					settings.parameterValues[ranged->getParameterID()] = ranged->convertFrom0to1(ranged->getValue());
+			return true;
+		}
+
+		const auto xml = juce::XmlDocument::parse(file);
+		if (xml == nullptr) {
+			error = "cannot parse preset " + file.getFullPathName();
+			return false;
+		}
+
+		for (auto* param : xml->getChildWithTagNameIterator("PARAM"))
+			settings.parameterValues[param->getStringAttribute("id")] = static_cast<float>(param->getDoubleAttribute("value"));
+		return true;
+	}
+
+	// Two inputs with the same name (from different folders, or with different extensions) would write
+	// the same output file, each worker overwriting the other's
+	bool checkOutputNames(const RenderSettings& settings, juce::String& error) {
+		std::map<juce::String, juce::File> outputs;
+
+		for (const auto& inputFile : settings.inputFiles) {
+			const auto key = getOutputFile(settings, inputFile).getFullPathName().toLowerCase();
+			const auto [existing, inserted] = outputs.emplace(key, inputFile);
+
+			if (!inserted) {
+				error = inputFile.getFullPathName() + " and " + existing->second.getFullPathName() + " would both render to "
+					+ getOutputFile(settings, inputFile).getFullPathName();
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	bool parseArguments(int argc, char* argv[], RenderSettings& settings, juce::String& error) {
+		for (int argIdx = 1; argIdx < argc; argIdx++) {
+			const juce::String arg(juce::CharPointer_UTF8(argv[argIdx]));
+			const auto value = arg.fromFirstOccurrenceOf("=", false, false);
+
+			if (arg.startsWith("--list=")) {
+				juce::StringArray lines;
+				juce::File::getCurrentWorkingDirectory().getChildFile(value).readLines(lines);
+				lines.removeEmptyStrings();
+				for (const auto& line : lines)
+					settings.inputFiles.add(juce::File::getCurrentWorkingDirectory().getChildFile(line.trim()));
+			}
+			else if (arg.startsWith("--output-dir=")) {
+				settings.outputDirectory = juce::File::getCurrentWorkingDirectory().getChildFile(value);
+			}
+			else if (arg.startsWith("--preset=")) {
+				if (!loadPreset(juce::File::getCurrentWorkingDirectory().getChildFile(value), settings, error))
+					return false;
+			}
+			else if (arg.startsWith("--set=")) {
+				settings.parameterValues[value.upToFirstOccurrenceOf("=", false, false)] = value.fromFirstOccurrenceOf("=", false, false).getFloatValue();
+			}
+			else if (arg.startsWith("--automation=")) {
+				if (!settings.automation.load(juce::File::getCurrentWorkingDirectory().getChildFile(value), error))
+					return false;
+			}
+			else if (arg.startsWith("--threads=")) {
+				settings.numThreads = juce::jmax(1, value.getIntValue());
+			}
+			else if (arg.startsWith("--block=")) {
+				settings.blockSize = juce::jlimit(16, 65536, value.getIntValue());
+			}
+			else if (arg == "--double") {
+				settings.doublePrecision = true;
+			}
+			else if (arg.startsWith("--")) {
+				error = "unknown option " + arg;
+				return false;
+			}
+			else {
+				settings.inputFiles.add(juce::File::getCurrentWorkingDirectory().getChildFile(arg));
+			}
+		}
+
+		if (settings.inputFiles.isEmpty()) error = "no input files";
+		else if (settings.outputDirectory == juce::File()) error = "--output-dir is required";
+		else checkOutputNames(settings, error);
+
+		return error.isEmpty();
+	}
+
+	// Unknown parameter IDs are reported once up front rather than silently ignored per file
+	bool validateParameterIDs(const RenderSettings& settings, juce::String& error) {
+		LPannerAudioProcessor processor;
+
+		for (const auto& entry : settings.parameterValues)
+			if (processor.parameters.getParameter(entry.first) == nullptr)
+				error = "unknown parameter " + entry.first;
+
+		// The latency is read once per file, so the output would shift when the spectral mode comes or goes
+		settings.automation.forEachParameterID([&](const juce::String& parameterID) {
+			if (processor.parameters.getParameter(parameterID) == nullptr)
+				error = "unknown parameter " + parameterID + " in automation";
+			else if (parameterID == "stereoMode")
+				error = "stereoMode cannot be automated, it changes the latency";
+		});
+
+		return error.isEmpty();
+	}
+}
+
+//==============================================================================
+int main(int argc, char* argv[]) {
+	const juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+	RenderSettings settings;
+	juce::String error;
+
+	if (!parseArguments(argc, argv, settings, error) || !validateParameterIDs(settings, error)) {
+		std::fprintf(stderr, "%s\nUsage: %s [--list=<file>] --output-dir=<dir> [--preset=<xml or state chunk>] [--set=<id>=<value>] "
+			"[--automation=<csv>] [--threads=<n>] [--block=<n>] [--double] <files...>\n", error.toRawUTF8(), argv[0]);
+		return 2;
+	}
+
+	if (!settings.outputDirectory.createDirectory()) {
+		std::fprintf(stderr, "cannot create %s\n", settings.outputDirectory.getFullPathName().toRawUTF8());
+		return 2;
+	}
+
+	const int numWorkers = juce::jmin(settings.numThreads, settings.inputFiles.size());
+	std::vector<RenderResult> results(static_cast<size_t>(settings.inputFiles.size()));
+	std::atomic<int> nextFileIndex{ 0 };
+
+	juce::ThreadPool pool(numWorkers);
+	std::vector<std::unique_ptr<RenderWorker>> workers;
+
+	const auto startMs = juce::Time::getMillisecondCounterHiRes();
+
+	for (int workerIdx = 0; workerIdx < numWorkers; workerIdx++) {
+		workers.push_back(std::make_unique<RenderWorker>(settings, nextFileIndex, results));
+		pool.addJob(workers.back().get(), false);
+	}
+
+	for (auto& worker : workers)
+		pool.waitForJobToFinish(worker.get(), -1);
+
+	const double wallSecs = (juce::Time::getMillisecondCounterHiRes() - startMs) * 0.001;
+
+	double totalAudioSecs = 0.0;
+	int numFailed = 0;
+
+	for (const auto& result : results) {
+		totalAudioSecs += result.audioSecs;
+		if (result.error.isNotEmpty()) numFailed++;
+	}
+
+	std::printf("\n%d files, %d failed, %.1f s of audio in %.2f s on %d workers: %.0fx realtime\n",
+		settings.inputFiles.size(), numFailed, totalAudioSecs, wallSecs, numWorkers, totalAudioSecs / juce::jmax(wallSecs, 1.0e-9));
+
+	return numFailed == 0 ? 0 : 1;
+}
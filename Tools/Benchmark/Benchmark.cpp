@@ -0,0 +1,350 @@
+/*
+  ==============================================================================
+
+	Headless benchmark for LPannerAudioProcessor.
+
+	Measures ns/sample and realtime throughput of processBlock for both
+	precisions, every processing scenario, a range of block sizes and sample
+	rates, at rest and under continuous automation. Before timing, every
+	scenario is checked against ReferenceProcessor, and the Lagrange and Thiran
+	delay interpolators are checked against its linear one on low sines.
+
+	Usage: LPannerBenchmark [--quick] [--seconds=<s>] [--check-only] [--bench-only]
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+#include "ReferenceProcessor.h"
+#include "RealtimeSafety.h"
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+namespace {
+	enum class Scenario {
+		classic,	// classic algorithm, fully wet
+		modern,		// modern algorithm, fully wet
+		crossfade,	// stereoMode flips every block, so the classic/modern crossfade keeps running
+		bypass		// bypassed at rest, bypass flipped every block under automation
+	};
+
+	constexpr Scenario SCENARIOS[] = { Scenario::classic, Scenario::modern, Scenario::crossfade, Scenario::bypass };
+	constexpr int BLOCK_SIZES[] = { 16, 64, 256, 1024, 4096 };
+	constexpr double SAMPLE_RATES[] = { 44100.0, 48000.0, 96000.0, 192000.0 };
+
+	constexpr int CHECK_BLOCKS = 400;
+
+	// At rest only rounding differs. Under automation the plugin rotates an exact linear phasor,
+	// while the float smoothers drift from a straight line by up to a few ulps per step.
+	constexpr double FLOAT_TOLERANCE = 1.0e-6;
+	constexpr double DOUBLE_TOLERANCE = 1.0e-12;
+	constexpr double AUTOMATION_TOLERANCE = 1.0e-4;
+
+	// Far below Nyquist every interpolator is close to exact, so they may only differ by their own errors
+	constexpr DelayInterpolation INTERPOLATIONS[] = { DelayInterpolation::lagrange3rd, DelayInterpolation::thiran };
+	constexpr double INTERPOLATION_TOLERANCE = 1.0e-3;
+	constexpr double SINE_FREQUENCIES[] = { 110.0, 170.0 };
+
+	const char* getScenarioName(Scenario scenario) {
+		switch (scenario) {
+		case Scenario::classic: return "classic";
+		case Scenario::modern: return "modern";
+		case Scenario::crossfade: return "crossfade";
+		case Scenario::bypass: return "bypass";
+		}
+		return "";
+	}
+
+	const char* getInterpolationName(DelayInterpolation interpolation) {
+		switch (interpolation) {
+		case DelayInterpolation::linear: return "linear";
+		case DelayInterpolation::lagrange3rd: return "lagrange";
+		case DelayInterpolation::thiran: return "thiran";
+		}
+		return "";
+	}
+
+	template <typename T>
+	const char* getPrecisionName() {
+		return std::is_same_v<T, float> ? "float" : "double";
+	}
+
+	//==============================================================================
+	// Parameter values for one block. Automation sweeps width, delay and rotation slowly,
+	// so every block sets new targets and the smoothers never come to rest.
+	ReferenceParameters getBlockParameters(Scenario scenario, bool automated, int blockIdx, double timeSecs) {
+		ReferenceParameters parameters;
+		parameters.stereo = 150.0f;
+		parameters.stereoMode = scenario == Scenario::classic ? 0 : 1;
+		parameters.delay = 5.0f;
+		parameters.rotation = 10.0f;
+
+		if (scenario == Scenario::crossfade)
+			parameters.stereoMode = blockIdx % 2;
+
+		if (scenario == Scenario::bypass)
+			parameters.bypass = automated ? blockIdx % 2 == 0 : true;
+
+		if (automated) {
+			const double phase = juce::MathConstants<double>::twoPi * 0.5 * timeSecs;
+
+			// Width stays above 100 %, otherwise the modern scenario would fall back to classic
+			parameters.stereo = static_cast<float>(150.0 + 45.0 * std::sin(phase));
+			parameters.delay = static_cast<float>(10.5 + 9.0 * std::sin(0.7 * phase));
+			parameters.rotation = static_cast<float>(40.0 * std::sin(1.3 * phase));
+		}
+
+		return parameters;
+	}
+
+	bool operator!=(const ReferenceParameters& a, const ReferenceParameters& b) {
+		return a.stereo != b.stereo || a.stereoMode != b.stereoMode || a.delay != b.delay
+			|| a.rotation != b.rotation || a.bypass != b.bypass;
+	}
+
+	void setParameter(LPannerAudioProcessor& processor, const char* parameterID, float value) {
+		auto* parameter = processor.parameters.getParameter(parameterID);
+		parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+	}
+
+	void applyParameters(LPannerAudioProcessor& processor, const ReferenceParameters& parameters) {
+		setParameter(processor, "stereo", parameters.stereo);
+		setParameter(processor, "stereoMode", static_cast<float>(parameters.stereoMode));
+		setParameter(processor, "delay", parameters.delay);
+		setParameter(processor, "rotation", parameters.rotation);
+		setParameter(processor, "bypass", parameters.bypass ? 1.0f : 0.0f);
+	}
+
+	// The values the processor ended up with, after normalisation and snapping to the parameter intervals
+	ReferenceParameters getAppliedParameters(LPannerAudioProcessor& processor) {
+		ReferenceParameters parameters;
+		parameters.stereo = *processor.parameters.getRawParameterValue("stereo");
+		parameters.stereoMode = static_cast<int>(*processor.parameters.getRawParameterValue("stereoMode"));
+		parameters.delay = *processor.parameters.getRawParameterValue("delay");
+		parameters.rotation = *processor.parameters.getRawParameterValue("rotation");
+		parameters.bypass = *processor.parameters.getRawParameterValue("bypass") >= 0.5f;
+		return parameters;
+	}
+
+	template <typename T>
+	void prepareProcessor(LPannerAudioProcessor& processor, double sampleRate, int blockSize, const ReferenceParameters& parameters) {
+		processor.setProcessingPrecision(std::is_same_v<T, double> ? juce::AudioProcessor::doublePrecision : juce::AudioProcessor::singlePrecision);
+		processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+		applyParameters(processor, parameters);
+		processor.prepareToPlay(sampleRate, blockSize);
+	}
+
+	template <typename T>
+	void fillNoise(juce::AudioBuffer<T>& buffer, juce::Random& random) {
+		for (int channel = 0; channel < buffer.getNumChannels(); channel++)
+			for (int sampleIdx = 0; sampleIdx < buffer.getNumSamples(); sampleIdx++)
+				buffer.setSample(channel, sampleIdx, static_cast<T>(random.nextFloat() - 0.5f));
+	}
+
+	// One sine per channel, continuing from startSample
+	template <typename T>
+	void fillSines(juce::AudioBuffer<T>& buffer, juce::int64 startSample, double sampleRate) {
+		for (int channel = 0; channel < buffer.getNumChannels(); channel++) {
+			const double increment = juce::MathConstants<double>::twoPi * SINE_FREQUENCIES[channel % 2] / sampleRate;
+			for (int sampleIdx = 0; sampleIdx < buffer.getNumSamples(); sampleIdx++)
+				buffer.setSample(channel, sampleIdx, static_cast<T>(0.5 * std::sin(increment * static_cast<double>(startSample + sampleIdx))));
+		}
+	}
+
+	//==============================================================================
+	// Runs the plugin and the reference side by side on host blocks of random length (up to
+	// twice the prepared size, so the chunking is exercised) and returns the largest difference.
+	// Any interpolation other than linear is fed low sines instead of noise.
+	template <typename T>
+	double checkEquivalence(Scenario scenario, bool automated, double sampleRate, int blockSize, DelayInterpolation interpolation = DelayInterpolation::linear) {
+		LPannerAudioProcessor processor;
+		ReferenceProcessor<T> reference;
+		juce::Random random(blockSize);
+		juce::MidiBuffer midiMessages;
+
+		setParameter(processor, "delayInterpolation", static_cast<float>(interpolation));
+		prepareProcessor<T>(processor, sampleRate, blockSize, getBlockParameters(scenario, automated, 0, 0.0));
+		reference.prepare(sampleRate, processor.parameters.getParameterRange("delay").end, getAppliedParameters(processor));
+
+		double maxError = 0.0;
+		double timeSecs = 0.0;
+		juce::int64 position = 0;
+
+		for (int blockIdx = 0; blockIdx < CHECK_BLOCKS; blockIdx++) {
+			const int numSamples = 1 + random.nextInt(2 * blockSize);
+
+			applyParameters(processor, getBlockParameters(scenario, automated, blockIdx, timeSecs));
+
+			juce::AudioBuffer<T> actual(2, numSamples);
+			if (interpolation == DelayInterpolation::linear)
+				fillNoise(actual, random);
+			else
+				fillSines(actual, position, sampleRate);
+			juce::AudioBuffer<T> expected(actual);
+
+			processor.processBlock(actual, midiMessages);
+			reference.process(expected, getAppliedParameters(processor));
+
+			for (int channel = 0; channel < 2; channel++)
+				for (int sampleIdx = 0; sampleIdx < numSamples; sampleIdx++)
+					maxError = juce::jmax(maxError, std::abs(static_cast<double>(actual.getSample(channel, sampleIdx) - expected.getSample(channel, sampleIdx))));
+
+			timeSecs += numSamples / sampleRate;
+			position += numSamples;
+		}
+
+		return maxError;
+	}
+
+	template <typename T>
+	bool runEquivalenceChecks() {
+		bool passed = true;
+
+		for (auto scenario : SCENARIOS) {
+			for (bool automated : { false, true }) {
+				const double tolerance = automated ? AUTOMATION_TOLERANCE : std::is_same_v<T, float> ? FLOAT_TOLERANCE : DOUBLE_TOLERANCE;
+
+				for (double sampleRate : { 44100.0, 96000.0 }) {
+					for (int blockSize : { 64, 1000 }) {
+						const double maxError = checkEquivalence<T>(scenario, automated, sampleRate, blockSize);
+						const bool ok = maxError <= tolerance;
+						passed = passed && ok;
+
+						std::printf("check  %-6s %-9s %-9s %6.1f kHz %5d  max error %.3g  %s\n",
+							getPrecisionName<T>(), getScenarioName(scenario), automated ? "automated" : "rest",
+							sampleRate * 0.001, blockSize, maxError, ok ? "ok" : "FAILED");
+					}
+				}
+			}
+		}
+
+		// The modern scenario is the only one that reads the delay line at rest; 5 ms is 220.5 samples at 44.1 kHz
+		for (auto interpolation : INTERPOLATIONS) {
+			for (bool automated : { false, true }) {
+				const double maxError = checkEquivalence<T>(Scenario::modern, automated, 44100.0, 256, interpolation);
+				const bool ok = maxError <= INTERPOLATION_TOLERANCE;
+				passed = passed && ok;
+
+				std::printf("check  %-6s %-9s %-9s %6.1f kHz %5d  max error %.3g  %s\n",
+					getPrecisionName<T>(), getInterpolationName(interpolation), automated ? "automated" : "rest",
+					44.1, 256, maxError, ok ? "ok" : "FAILED");
+			}
+		}
+
+		return passed;
+	}
+
+	//==============================================================================
+	// Streams `seconds` of noise through the processor in fixed-size blocks and returns ns per sample frame
+	template <typename T>
+	double measure(Scenario scenario, bool automated, double sampleRate, int blockSize, double seconds) {
+		LPannerAudioProcessor processor;
+		juce::Random random(1);
+		juce::MidiBuffer midiMessages;
+
+		auto parameters = getBlockParameters(scenario, automated, 0, 0.0);
+		prepareProcessor<T>(processor, sampleRate, blockSize, parameters);
+
+		const int numBlocks = juce::jmax(1, static_cast<int>(seconds * sampleRate / blockSize));
+		juce::AudioBuffer<T> input(2, numBlocks * blockSize);
+		juce::AudioBuffer<T> work(2, numBlocks * blockSize);
+		fillNoise(input, random);
+
+		const auto restoreInput = [&] {
+			for (int channel = 0; channel < 2; channel++)
+				work.copyFrom(channel, 0, input, channel, 0, input.getNumSamples());
+		};
+
+		const auto run = [&] {
+			for (int blockIdx = 0; blockIdx < numBlocks; blockIdx++) {
+				// Only touch parameters that a host would actually change
+				const auto next = getBlockParameters(scenario, automated, blockIdx, blockIdx * blockSize / sampleRate);
+				if (next != parameters) {
+					parameters = next;
+					applyParameters(processor, parameters);
+				}
+
+				juce::AudioBuffer<T> block(work.getArrayOfWritePointers(), 2, blockIdx * blockSize, blockSize);
+				processor.processBlock(block, midiMessages);
+			}
+		};
+
+		// The first pass warms caches and the delay line; only the second is timed
+		restoreInput();
+		run();
+		restoreInput();
+
+		const auto start = std::chrono::steady_clock::now();
+		run();
+		const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+		return elapsed / (static_cast<double>(numBlocks) * blockSize);
+	}
+
+	template <typename T>
+	void runBenchmarks(bool quick, double seconds) {
+		for (auto scenario : SCENARIOS) {
+			for (bool automated : { false, true }) {
+				for (double sampleRate : SAMPLE_RATES) {
+					if (quick && sampleRate != 48000.0) continue;
+
+					for (int blockSize : BLOCK_SIZES) {
+						if (quick && blockSize != 64 && blockSize != 1024) continue;
+
+						const double nsPerSample = measure<T>(scenario, automated, sampleRate, blockSize, seconds);
+
+						std::printf("bench  %-6s %-9s %-9s %6.1f kHz %5d  %8.2f ns/sample  %8.2f Msample/s  %9.0fx realtime\n",
+							getPrecisionName<T>(), getScenarioName(scenario), automated ? "automated" : "rest",
+							sampleRate * 0.001, blockSize, nsPerSample, 1000.0 / nsPerSample, 1.0e9 / (nsPerSample * sampleRate));
+						std::fflush(stdout);
+					}
+				}
+			}
+		}
+	}
+}
+
+//==============================================================================
+int main(int argc, char* argv[]) {
+	const juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+	bool quick = false, check = true, bench = true;
+	double seconds = 1.0;
+
+	for (int argIdx = 1; argIdx < argc; argIdx++) {
+		const std::string arg = argv[argIdx];
+
+		if (arg == "--quick") quick = true;
+		else if (arg == "--check-only") bench = false;
+		else if (arg == "--bench-only") check = false;
+		else if (arg.rfind("--seconds=", 0) == 0) seconds = juce::jmax(0.01, std::stod(arg.substr(10)));
+		else {
+			std::fprintf(stderr, "Usage: %s [--quick] [--seconds=<s>] [--check-only] [--bench-only]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	bool passed = true;
+
+	if (check) {
+		passed = runEquivalenceChecks<float>() && passed;
+		passed = runEquivalenceChecks<double>() && passed;
+	}
+
+	if (bench) {
+		runBenchmarks<float>(quick, seconds);
+		runBenchmarks<double>(quick, seconds);
+	}
+
+#if LPANNER_RT_CHECKS
+	// Every processBlock call above ran inside the checked section
+	const int violations = RealtimeSafety::getViolationCount();
+	std::printf("rt-checks  %d violation(s)  %s\n", violations, violations == 0 ? "ok" : "FAILED");
+	passed = passed && violations == 0;
+#endif
+
+	return passed ? 0 : 1;
+}
@@ -0,0 +1,135 @@
+/*
+  ==============================================================================
+
+	Scalar, sample-by-sample model of LPannerAudioProcessor used as the
+	equivalence baseline for the benchmark.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// Plain parameter values in the units of the processor's parameters
+struct ReferenceParameters {
+	float stereo = 100.0f;
+	int stereoMode = 1;
+	float delay = 5.0f;
+	float rotation = 0.0f;
+	bool bypass = false;
+};
+
+//==============================================================================
+/**
+	Evaluates the full classic/modern/dry blend for every sample with direct cos/sin and a
+	linearly interpolated delay, with the same smoothing and true-bypass behaviour as the
+	plugin. It has no chunking, kernel specialisation or vectorisation, so differences to the
+	plugin only come from rounding.
+*/
+template <typename T>
+class ReferenceProcessor {
+public:
+	void prepare(double sampleRate, float maximumDelayMs, const ReferenceParameters& parameters) {
+		constexpr double smoothingTimeSecs = 0.01;
+
+		stereoSmoothed.reset(sampleRate, smoothingTimeSecs);
+		stereoSmoothed.setCurrentAndTargetValue(parameters.stereo);
+		stereoModeSmoothed.reset(sampleRate, smoothingTimeSecs);
+		stereoModeSmoothed.setCurrentAndTargetValue(getStereoModeTarget(parameters));
+		delaySmoothed.reset(sampleRate, smoothingTimeSecs);
+		delaySmoothed.setCurrentAndTargetValue(parameters.delay);
+		rotationSmoothed.reset(sampleRate, smoothingTimeSecs);
+		rotationSmoothed.setCurrentAndTargetValue(parameters.rotation);
+		dryWetSmoothed.reset(sampleRate, smoothingTimeSecs);
+		dryWetSmoothed.setCurrentAndTargetValue(parameters.bypass ? 0.0f : 1.0f);
+
+		delayMsToSamples = sampleRate * 0.001;
+		history.assign(static_cast<size_t>(std::ceil(maximumDelayMs * delayMsToSamples)) + 2, T());
+		writePosition = 0;
+	}
+
+	void process(juce::AudioBuffer<T>& buffer, const ReferenceParameters& parameters) {
+		auto* leftPtr = buffer.getWritePointer(0);
+		auto* rightPtr = buffer.getWritePointer(1);
+		const int numSamples = buffer.getNumSamples();
+
+		stereoSmoothed.setTargetValue(parameters.stereo);
+		stereoModeSmoothed.setTargetValue(getStereoModeTarget(parameters));
+		delaySmoothed.setTargetValue(parameters.delay);
+		rotationSmoothed.setTargetValue(parameters.rotation);
+		dryWetSmoothed.setTargetValue(parameters.bypass ? 0.0f : 1.0f);
+
+		// True bypass: only the mid history advances and the other smoothers jump to their targets
+		if (!dryWetSmoothed.isSmoothing() && dryWetSmoothed.getTargetValue() <= 0.0f) {
+			for (int sampleIdx = 0; sampleIdx < numSamples; sampleIdx++)
+				pushMid(leftPtr[sampleIdx], rightPtr[sampleIdx]);
+
+			stereoSmoothed.setCurrentAndTargetValue(stereoSmoothed.getTargetValue());
+			stereoModeSmoothed.setCurrentAndTargetValue(stereoModeSmoothed.getTargetValue());
+			delaySmoothed.setCurrentAndTargetValue(delaySmoothed.getTargetValue());
+			rotationSmoothed.setCurrentAndTargetValue(rotationSmoothed.getTargetValue());
+			return;
+		}
+
+		for (int sampleIdx = 0; sampleIdx < numSamples; sampleIdx++) {
+			const T width = static_cast<T>(stereoSmoothed.getNextValue()) * static_cast<T>(0.01);
+			const T mix = static_cast<T>(stereoModeSmoothed.getNextValue());
+			const T delaySamples = static_cast<T>(delaySmoothed.getNextValue()) * static_cast<T>(delayMsToSamples);
+			const T angle = juce::degreesToRadians(static_cast<T>(rotationSmoothed.getNextValue()));
+			const T wet = static_cast<T>(dryWetSmoothed.getNextValue());
+
+			const T cosTheta = std::cos(angle);
+			const T sinTheta = std::sin(angle);
+			const T left = leftPtr[sampleIdx];
+			const T right = rightPtr[sampleIdx];
+
+			pushMid(left, right);
+			const T midDelaySignal = readDelayed(delaySamples);
+
+			// Classic: width scaling of mid/side, then rotation
+			const T f1 = (1 + width) / 2;
+			const T f2 = (1 - width) / 2;
+			const T leftClassic = (f1 * cosTheta - f2 * sinTheta) * left + (f2 * cosTheta - f1 * sinTheta) * right;
+			const T rightClassic = (f1 * sinTheta + f2 * cosTheta) * left + (f2 * sinTheta + f1 * cosTheta) * right;
+
+			// Modern: rotation plus the delayed mid weighted by the width
+			const T leftModern = left * cosTheta - right * sinTheta + (width - 1) * (cosTheta + sinTheta) / 2 * midDelaySignal;
+			const T rightModern = left * sinTheta + right * cosTheta + (width - 1) * (sinTheta - cosTheta) / 2 * midDelaySignal;
+
+			leftPtr[sampleIdx] = (1 - wet) * left + wet * ((1 - mix) * leftClassic + mix * leftModern);
+			rightPtr[sampleIdx] = (1 - wet) * right + wet * ((1 - mix) * rightClassic + mix * rightModern);
+		}
+	}
+
+private:
+	juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> stereoSmoothed;
+	juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> stereoModeSmoothed;
+	juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> delaySmoothed;
+	juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> rotationSmoothed;
+	juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> dryWetSmoothed;
+
+	double delayMsToSamples = 0.0;
+	std::vector<T> history;
+	size_t writePosition = 0;
+
+	// The modern algorithm only applies above 100 % width
+	static float getStereoModeTarget(const ReferenceParameters& parameters) {
+		return (parameters.stereoMode == 0 || parameters.stereo < 100.0f) ? 0.0f : 1.0f;
+	}
+
+	void pushMid(T left, T right) {
+		writePosition = (writePosition + 1) % history.size();
+		history[writePosition] = (left + right) / 2;
+	}
+
+	T getDelayed(int delaySamples) const {
+		return history[(writePosition + history.size() - static_cast<size_t>(delaySamples)) % history.size()];
+	}
+
+	T readDelayed(T delaySamples) const {
+		const int delayInt = static_cast<int>(delaySamples);
+		const T delayFrac = delaySamples - static_cast<T>(delayInt);
+		return getDelayed(delayInt) + delayFrac * (getDelayed(delayInt + 1) - getDelayed(delayInt));
+	}
+};
@@ -0,0 +1,363 @@
+/*
+  ==============================================================================
+
+	Multi-instance stress test for LPannerAudioProcessor.
+
+	Simulates a host graph: N instances, each with its own buffers, are processed
+	once per audio period by a pool of worker threads that pull the next
+	instance from a shared counter. Cycles are released on the period grid, as an
+	audio device would, and a cycle that does not finish within its period is a
+	deadline miss.
+
+	The test repeats for every worker count and reports per-block and per-cycle
+	p50/p99 times, deadline misses, the process RSS and the scaling efficiency
+	relative to the first worker count (one by default). Regressions in memory
+	footprint, cache behaviour or false sharing between instances show up as
+	lost efficiency.
+
+	Usage: LPannerStress [--instances=<n>] [--threads=<n,n,...>] [--block=<n>]
+	                     [--rate=<hz>] [--seconds=<s>] [--mode=classic|modern|spectral]
+	                     [--automate] [--double]
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+
+namespace {
+	using Clock = std::chrono::steady_clock;
+
+	constexpr int DEFAULT_INSTANCES = 300;
+	constexpr int DEFAULT_BLOCK_SIZE = 256;
+	constexpr double DEFAULT_SAMPLE_RATE = 48000.0;
+	constexpr double DEFAULT_SECONDS = 5.0;
+
+	// Input is looped from a shared noise table, so no instance ever becomes silent and skips its blocks
+	constexpr int NOISE_LENGTH = 1 << 16;
+
+	struct StressSettings {
+		int numInstances = DEFAULT_INSTANCES;
+		std::vector<int> threadCounts;
+		int blockSize = DEFAULT_BLOCK_SIZE;
+		double sampleRate = DEFAULT_SAMPLE_RATE;
+		double seconds = DEFAULT_SECONDS;
+		int stereoMode = 1;
+		bool automate = false;
+		bool doublePrecision = false;
+	};
+
+	//==============================================================================
+	// Log-spaced histogram of durations: no allocation while recording, ~2 % resolution
+	class DurationHistogram {
+	public:
+		void add(double nanoseconds) {
+			const double position = std::log2(juce::jmax(1.0, nanoseconds)) * BUCKETS_PER_OCTAVE;
+			counts[static_cast<size_t>(juce::jlimit(0, NUM_BUCKETS - 1, static_cast<int>(position)))]++;
+			total++;
+		}
+
+		void merge(const DurationHistogram& other) {
+			for (size_t bucketIdx = 0; bucketIdx < counts.size(); bucketIdx++) counts[bucketIdx] += other.counts[bucketIdx];
+			total += other.total;
+		}
+
+		// Upper edge of the bucket holding the given fraction of all values, in nanoseconds
+		double getPercentile(double fraction) const {
+			const auto target = static_cast<juce::int64>(std::ceil(fraction * static_cast<double>(total)));
+			juce::int64 count = 0;
+
+			for (size_t bucketIdx = 0; bucketIdx < counts.size(); bucketIdx++) {
+				count += counts[bucketIdx];
+				if (count >= target && count > 0) return std::exp2(static_cast<double>(bucketIdx + 1) / BUCKETS_PER_OCTAVE);
+			}
+			return 0.0;
+		}
+
+	private:
+		static constexpr int BUCKETS_PER_OCTAVE = 32;
+		static constexpr int NUM_BUCKETS = 40 * BUCKETS_PER_OCTAVE;	// up to ~18 minutes
+
+		std::array<juce::int64, NUM_BUCKETS> counts{};
+		juce::int64 total = 0;
+	};
+
+	// Resident set size of the whole process in bytes, from /proc (0 where it is unavailable)
+	juce::int64 getResidentBytes() {
+		std::ifstream status("/proc/self/status");
+		std::string line;
+
+		while (std::getline(status, line))
+			if (line.rfind("VmRSS:", 0) == 0)
+				return std::stoll(line.substr(6)) * 1024;
+
+		return 0;
+	}
+
+	//==============================================================================
+	// One plugin instance with the buffers a host would hand it
+	struct Instance {
+		std::unique_ptr<LPannerAudioProcessor> processor;
+		juce::AudioBuffer<float> bufferF;
+		juce::AudioBuffer<double> bufferD;
+		int noisePosition = 0;
+	};
+
+	struct CycleStats {
+		DurationHistogram cycleTimes;
+		DurationHistogram blockTimes;
+		double totalCycleNanoseconds = 0.0;
+		int numCycles = 0;
+		int deadlineMisses = 0;
+	};
+
+	/**
+		The graph: instances, workers and the cycle hand-off. Workers sleep on their own event
+		between cycles, like a host's audio worker threads; the worker that finishes the last
+		instance of a cycle wakes the driver.
+	*/
+	class StressGraph {
+	public:
+		StressGraph(const StressSettings& stressSettings) : settings(stressSettings), instances(static_cast<size_t>(stressSettings.numInstances)) {
+			juce::Random random;
+			for (auto& sample : noise) sample = random.nextFloat() - 0.5f;
+
+			for (size_t instanceIdx = 0; instanceIdx < instances.size(); instanceIdx++) {
+				auto& instance = instances[instanceIdx];
+				instance.processor = std::make_unique<LPannerAudioProcessor>();
+				instance.noisePosition = static_cast<int>((instanceIdx * 7919) % NOISE_LENGTH);
+
+				auto& processor = *instance.processor;
+				setParameter(processor, "stereoMode", static_cast<float>(settings.stereoMode));
+				setParameter(processor, "stereo", 150.0f);
+				setParameter(processor, "rotation", 10.0f);
+
+				processor.setProcessingPrecision(settings.doublePrecision ? juce::AudioProcessor::doublePrecision : juce::AudioProcessor::singlePrecision);
+				processor.setRateAndBufferSizeDetails(settings.sampleRate, settings.blockSize);
+				processor.prepareToPlay(settings.sampleRate, settings.blockSize);
+
+				if (settings.doublePrecision) instance.bufferD.setSize(2, settings.blockSize);
+				else instance.bufferF.setSize(2, settings.blockSize);
+			}
+		}
+
+		~StressGraph() {
+			for (auto& instance : instances)
+				instance.processor->releaseResources();
+		}
+
+		// Runs settings.seconds of audio on numWorkers threads, paced on the period grid
+		CycleStats run(int numWorkers) {
+			const auto period = std::chrono::duration<double>(settings.blockSize / settings.sampleRate);
+			const int numCycles = juce::jmax(1, static_cast<int>(settings.seconds * settings.sampleRate / settings.blockSize));
+
+			std::vector<std::unique_ptr<Worker>> workers;
+			for (int workerIdx = 0; workerIdx < numWorkers; workerIdx++) {
+				workers.push_back(std::make_unique<Worker>(*this));
+				workers.back()->startThread(juce::Thread::Priority::high);
+			}
+
+			CycleStats stats;
+			auto release = Clock::now();
+
+			for (int cycleIdx = 0; cycleIdx < numCycles; cycleIdx++) {
+				std::this_thread::sleep_until(release);
+
+				const auto start = Clock::now();
+				cycleNumber = cycleIdx;
+				remaining = static_cast<int>(instances.size());
+				nextInstance = 0;
+				for (auto& worker : workers) worker->startEvent.signal();
+
+				cycleDone.wait(-1);
+				const auto end = Clock::now();
+
+				const double cycleNanoseconds = std::chrono::duration<double, std::nano>(end - start).count();
+				stats.cycleTimes.add(cycleNanoseconds);
+				stats.totalCycleNanoseconds += cycleNanoseconds;
+				stats.numCycles++;
+
+				// A late cycle pushes the grid back instead of bunching the following ones up
+				release += std::chrono::duration_cast<Clock::duration>(period);
+				if (end > release) {
+					stats.deadlineMisses++;
+					release = end;
+				}
+			}
+
+			for (auto& worker : workers) {
+				worker->signalThreadShouldExit();
+				worker->startEvent.signal();
+				worker->stopThread(-1);
+				stats.blockTimes.merge(worker->blockTimes);
+			}
+
+			return stats;
+		}
+
+	private:
+		//==============================================================================
+		class Worker : public juce::Thread {
+		public:
+			explicit Worker(StressGraph& stressGraph) : juce::Thread("LPanner stress worker"), graph(stressGraph) {}
+
+			void run() override {
+				while (!threadShouldExit()) {
+					startEvent.wait(-1);
+					if (threadShouldExit()) break;
+
+					for (int instanceIdx = graph.nextInstance++; instanceIdx < static_cast<int>(graph.instances.size()); instanceIdx = graph.nextInstance++) {
+						const auto nanoseconds = graph.settings.doublePrecision ? graph.processInstance<double>(graph.instances[static_cast<size_t>(instanceIdx)])
+							: graph.processInstance<float>(graph.instances[static_cast<size_t>(instanceIdx)]);
+						blockTimes.add(nanoseconds);
+
+						if (--graph.remaining == 0)
+							graph.cycleDone.signal();
+					}
+				}
+			}
+
+			juce::WaitableEvent startEvent;
+			DurationHistogram blockTimes;
+
+		private:
+			StressGraph& graph;
+		};
+
+		//==============================================================================
+		const StressSettings& settings;
+		std::vector<Instance> instances;
+		std::array<float, NOISE_LENGTH> noise{};
+
+		// Each counter on its own cache line, so the hand-off itself does not false-share
+		alignas(64) std::atomic<int> nextInstance{ 0 };
+		alignas(64) std::atomic<int> remaining{ 0 };
+		alignas(64) std::atomic<int> cycleNumber{ 0 };
+		juce::WaitableEvent cycleDone;
+
+		static void setParameter(LPannerAudioProcessor& processor, const char* parameterID, float value) {
+			auto* parameter = processor.parameters.getParameter(parameterID);
+			parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+		}
+
+		// Fills the instance's input outside the measurement and returns the time of processBlock alone
+		template <typename T>
+		double processInstance(Instance& instance) {
+			auto& buffer = [&instance]() -> juce::AudioBuffer<T>& {
+				if constexpr (std::is_same_v<T, float>) return instance.bufferF;
+				else return instance.bufferD;
+			}();
+
+			for (int channel = 0; channel < 2; channel++) {
+				auto* channelPtr = buffer.getWritePointer(channel);
+				for (int sampleIdx = 0; sampleIdx < settings.blockSize; sampleIdx++)
+					channelPtr[sampleIdx] = static_cast<T>(noise[static_cast<size_t>((instance.noisePosition + channel * 4099 + sampleIdx) & (NOISE_LENGTH - 1))]);
+			}
+			instance.noisePosition = (instance.noisePosition + settings.blockSize) & (NOISE_LENGTH - 1);
+
+			// Host automation arrives on the audio thread, right before the block
+			if (settings.automate) {
+				const double timeSecs = cycleNumber * settings.blockSize / settings.sampleRate;
+				setParameter(*instance.processor, "rotation", static_cast<float>(45.0 * std::sin(juce::MathConstants<double>::twoPi * 0.5 * timeSecs)));
+			}
+
+			juce::MidiBuffer midiMessages;
+			const auto start = Clock::now();
+			instance.processor->processBlock(buffer, midiMessages);
+			return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+		}
+	};
+
+	//==============================================================================
+	bool parseArguments(int argc, char* argv[], StressSettings& settings) {
+		for (int argIdx = 1; argIdx < argc; argIdx++) {
+			const std::string arg = argv[argIdx];
+			const auto value = arg.substr(arg.find('=') + 1);
+
+			if (arg.rfind("--instances=", 0) == 0) settings.numInstances = juce::jmax(1, std::atoi(value.c_str()));
+			else if (arg.rfind("--block=", 0) == 0) settings.blockSize = juce::jlimit(16, 8192, std::atoi(value.c_str()));
+			else if (arg.rfind("--rate=", 0) == 0) settings.sampleRate = juce::jlimit(8000.0, 384000.0, std::atof(value.c_str()));
+			else if (arg.rfind("--seconds=", 0) == 0) settings.seconds = juce::jmax(0.1, std::atof(value.c_str()));
+			else if (arg == "--mode=classic") settings.stereoMode = 0;
+			else if (arg == "--mode=modern") settings.stereoMode = 1;
+			else if (arg == "--mode=spectral") settings.stereoMode = 2;
+			else if (arg == "--automate") settings.automate = true;
+			else if (arg == "--double") settings.doublePrecision = true;
+			else if (arg.rfind("--threads=", 0) == 0) {
+				size_t start = 0;
+				while (start < value.size()) {
+					const auto end = std::min(value.find(',', start), value.size());
+					settings.threadCounts.push_back(juce::jmax(1, std::atoi(value.substr(start, end - start).c_str())));
+					start = end + 1;
+				}
+			}
+			else return false;
+		}
+
+		// Default sweep: powers of two up to the core count, and the core count itself
+		if (settings.threadCounts.empty()) {
+			const int numCpus = juce::SystemStats::getNumCpus();
+			for (int numThreads = 1; numThreads < numCpus; numThreads *= 2) settings.threadCounts.push_back(numThreads);
+			settings.threadCounts.push_back(numCpus);
+		}
+
+		return true;
+	}
+}
+
+//==============================================================================
+int main(int argc, char* argv[]) {
+	const juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+	StressSettings settings;
+	if (!parseArguments(argc, argv, settings)) {
+		std::fprintf(stderr, "Usage: %s [--instances=<n>] [--threads=<n,n,...>] [--block=<n>] [--rate=<hz>] [--seconds=<s>] "
+			"[--mode=classic|modern|spectral] [--automate] [--double]\n", argv[0]);
+		return 2;
+	}
+
+	const double periodMicroseconds = settings.blockSize / settings.sampleRate * 1.0e6;
+	std::printf("%d instances, %s, %s, block %d at %.1f kHz (period %.0f us), %.1f s per run\n",
+		settings.numInstances, settings.stereoMode == 0 ? "classic" : settings.stereoMode == 1 ? "modern" : "spectral",
+		settings.doublePrecision ? "double" : "float", settings.blockSize, settings.sampleRate * 0.001, periodMicroseconds, settings.seconds);
+
+	const auto residentBefore = getResidentBytes();
+	StressGraph graph(settings);
+	const auto residentAfter = getResidentBytes();
+
+	std::printf("rss    %.1f MiB total, %.1f KiB per instance\n\n", residentAfter / 1048576.0,
+		(residentAfter - residentBefore) / 1024.0 / settings.numInstances);
+	std::printf("threads  block p50  block p99  cycle p50  cycle p99  misses           efficiency\n");
+
+	double singleThreadCycle = 0.0;
+	int singleThreadCount = 0;
+
+	for (const int numThreads : settings.threadCounts) {
+		const auto stats = graph.run(numThreads);
+		const double meanCycle = stats.totalCycleNanoseconds / stats.numCycles;
+
+		// Efficiency against the first run: 100 % means the cycle shrank in proportion to the added workers
+		if (singleThreadCount == 0) {
+			singleThreadCycle = meanCycle;
+			singleThreadCount = numThreads;
+		}
+		const double efficiency = singleThreadCycle * singleThreadCount / (meanCycle * numThreads);
+
+		std::printf("%7d  %6.1f us  %6.1f us  %6.0f us  %6.0f us  %5d / %-6d  %9.1f %%\n", numThreads,
+			stats.blockTimes.getPercentile(0.5) * 0.001, stats.blockTimes.getPercentile(0.99) * 0.001,
+			stats.cycleTimes.getPercentile(0.5) * 0.001, stats.cycleTimes.getPercentile(0.99) * 0.001,
+			stats.deadlineMisses, stats.numCycles, efficiency * 100.0);
+		std::fflush(stdout);
+	}
+
+	std::printf("\nrss    %.1f MiB after all runs\n", getResidentBytes() / 1048576.0);
+	return 0;
+}
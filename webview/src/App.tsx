@@ -7,6 +7,9 @@ import JuceSwitcher from "./components/JuceSwitcher";
 import JuceSlider from "./components/JuceSlider";
 import JuceKnob from "./components/JuceKnob";
 import Header from "./components/Header";
+import { getComboBoxState } from "./parameters";
+import Goniometer from "./components/Goniometer";
+import LoadMeter from "./components/LoadMeter";
 
 // Plugin info type
 interface PluginInfo {
@@ -34,6 +37,9 @@ const STYLES = {
     height: "100vh",
     background: THEME.colors.background,
   },
+  headerSection: {
+    width: "100%",
+  },
   stereoSection: {
     width: "100%",
   },
@@ -56,8 +62,15 @@ const STYLES = {
   },
 } as const;
 
+// stereoMode choice indices
+const STEREO_MODE = {
+  classic: 0,
+  modern: 1,
+  spectral: 2,
+} as const;
+
 const App: FC = () => {
-  const [isModern, setIsModern] = useState<boolean>(false);
+  const [stereoModeIndex, setStereoModeIndex] = useState<number>(STEREO_MODE.classic);
   const [pluginInfo, setPluginInfo] = useState<PluginInfo>();
 
   // Get plugin info from C++
@@ -81,21 +94,14 @@ const App: FC = () => {
     initializePluginInfo();
   }, []);
 
-  // Get stereoMode state
+  // Follow stereoMode, including its initial value and host automation
   useEffect(() => {
-    const initializeStereoMode = async () => {
-      try {
-        // @ts-expect-error Juce does not have types
-        const { getComboBoxState } = await import("juce-framework-frontend");
-        const stereoModeState = getComboBoxState("stereoMode");
-        const initialIndex = stereoModeState.getChoiceIndex();
-        setIsModern(initialIndex === 1);
-      } catch (error) {
-        console.error("Failed to initialize stereo mode:", error);
-      }
-    };
+    const stereoModeState = getComboBoxState("stereoMode");
+    const handleValueChange = () => setStereoModeIndex(stereoModeState.getChoiceIndex());
 
-    initializeStereoMode();
+    handleValueChange();
+    const listenerId = stereoModeState.valueChangedEvent.addListener(handleValueChange);
+    return () => stereoModeState.valueChangedEvent.removeListener(listenerId);
   }, []);
 
   // Detect Space key
@@ -142,8 +148,8 @@ const App: FC = () => {
   }, []);
 
   // Handle stereoMode change
-  const handleStereoModeChange = (index: boolean) => {
-    setIsModern(index);
+  const handleStereoModeChange = (index: number) => {
+    setStereoModeIndex(index);
   };
 
   // Stereo Image header section
@@ -156,26 +162,42 @@ const App: FC = () => {
           </Typography.Title>
           <JuceSwitcher
             identifier="stereoMode"
-            titles={["Classic", "Modern"]}
+            titles={["Classic", "Modern", "Spectral"]}
             level={2}
             primaryColor={THEME.colors.primary}
             secondaryColor={THEME.colors.secondary}
             onChange={handleStereoModeChange}
           />
         </Flex>
-        <JuceKnob
-          title="delay"
-          suffix="ms"
-          identifier="delay"
-          min={1.0}
-          max={20.0}
-          defaultValue={5.0}
-          primaryColor={THEME.colors.primary}
-          secondaryColor={THEME.colors.secondary}
-          accentColor={THEME.colors.accent}
-          size={20}
-          disabled={!isModern}
-        />
+        {stereoModeIndex === STEREO_MODE.spectral ? (
+          // Width at 20 Hz; the slider sets the width at 20 kHz
+          <JuceKnob
+            title="low"
+            suffix="%"
+            identifier="spectralLowWidth"
+            min={0}
+            max={200}
+            defaultValue={100}
+            primaryColor={THEME.colors.primary}
+            secondaryColor={THEME.colors.secondary}
+            accentColor={THEME.colors.accent}
+            size={20}
+          />
+        ) : (
+          <JuceKnob
+            title="delay"
+            suffix="ms"
+            identifier="delay"
+            min={1.0}
+            max={20.0}
+            defaultValue={5.0}
+            primaryColor={THEME.colors.primary}
+            secondaryColor={THEME.colors.secondary}
+            accentColor={THEME.colors.accent}
+            size={20}
+            disabled={stereoModeIndex !== STEREO_MODE.modern}
+          />
+        )}
       </Flex>
       <JuceSlider identifier="stereo" min={0} max={200} mark={0.5} primaryColor={THEME.colors.primary} secondaryColor={THEME.colors.secondary} accentColor={THEME.colors.accent} />
     </>
@@ -203,7 +225,13 @@ const App: FC = () => {
   return (
     <Layout className="root">
       <Flex vertical justify="space-between" align="start" style={STYLES.rootContainer}>
-        <Header $primaryColor={THEME.colors.primary} pluginName={pluginInfo?.name as string} pluginVersion={pluginInfo?.version as string} />
+        <Flex justify="space-between" align="center" style={STYLES.headerSection}>
+          <Header $primaryColor={THEME.colors.primary} pluginName={pluginInfo?.name as string} pluginVersion={pluginInfo?.version as string} />
+          <Flex align="center" gap="middle">
+            <LoadMeter primaryColor={THEME.colors.primary} accentColor={THEME.colors.accent} />
+            <Goniometer primaryColor={THEME.colors.primary} secondaryColor={THEME.colors.secondary} accentColor={THEME.colors.accent} />
+          </Flex>
+        </Flex>
         {renderStereoSection()}
         {renderRotationSection()}
       </Flex>
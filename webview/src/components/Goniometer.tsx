@@ -0,0 +1,113 @@
+import { type FC, useEffect, useRef, useState, type CSSProperties } from "react";
+import { Flex, Typography } from "antd";
+
+// Event sent by the editor at a capped frame rate
+interface AnalysisEvent {
+  correlation: number;
+  balance: number;
+  points: string; // base64 Float32Array of interleaved (side, mid) points
+}
+
+interface GoniometerProps {
+  size?: number;
+  primaryColor: string;
+  secondaryColor: string;
+  accentColor: string;
+}
+
+// Constants
+const DEFAULT_SIZE = 80;
+const POINT_SIZE = 1.5;
+const METER_HEIGHT = 4;
+
+// Decode base64 without going through JSON number parsing
+const decodePoints = (base64: string): Float32Array => {
+  const binary = atob(base64);
+  const bytes = new Uint8Array(binary.length);
+  for (let i = 0; i < binary.length; i++) bytes[i] = binary.charCodeAt(i);
+  return new Float32Array(bytes.buffer);
+};
+
+const Goniometer: FC<GoniometerProps> = ({ size = DEFAULT_SIZE, primaryColor, secondaryColor, accentColor }) => {
+  const canvasRef = useRef<HTMLCanvasElement>(null);
+  const [correlation, setCorrelation] = useState(1);
+  const [balance, setBalance] = useState(0);
+
+  // Subscribe to analysis events and draw straight to the canvas, outside of React renders
+  useEffect(() => {
+    // @ts-expect-error Juce does not have types
+    const backend = window.__JUCE__?.backend;
+    if (!backend) return;
+
+    const handleAnalysis = (event: AnalysisEvent) => {
+      setCorrelation(event.correlation);
+      setBalance(event.balance);
+
+      const context = canvasRef.current?.getContext("2d");
+      if (!context) return;
+
+      const points = decodePoints(event.points);
+      const half = size / 2;
+
+      context.clearRect(0, 0, size, size);
+      context.strokeStyle = secondaryColor;
+      context.beginPath();
+      context.moveTo(half, 0);
+      context.lineTo(half, size);
+      context.moveTo(0, half);
+      context.lineTo(size, half);
+      context.stroke();
+
+      context.fillStyle = accentColor;
+      for (let i = 0; i + 1 < points.length; i += 2) {
+        const x = half + Math.max(-1, Math.min(1, points[i])) * half;
+        const y = half - Math.max(-1, Math.min(1, points[i + 1])) * half;
+        context.fillRect(x, y, POINT_SIZE, POINT_SIZE);
+      }
+    };
+
+    const listenerId = backend.addEventListener("analysis", handleAnalysis);
+    return () => backend.removeEventListener(listenerId);
+  }, [size, secondaryColor, accentColor]);
+
+  const styles = {
+    canvas: {
+      width: `${size}px`,
+      height: `${size}px`,
+      border: `1px solid ${primaryColor}`,
+      borderRadius: "50%",
+    } as CSSProperties,
+    meter: {
+      position: "relative",
+      width: `${size}px`,
+      height: `${METER_HEIGHT}px`,
+      background: secondaryColor,
+    } as CSSProperties,
+    // Correlation grows from the centre: right for in phase, left for out of phase
+    meterFill: {
+      position: "absolute",
+      left: `${50 + Math.min(0, correlation) * 50}%`,
+      width: `${Math.abs(correlation) * 50}%`,
+      height: "100%",
+      background: correlation < 0 ? accentColor : primaryColor,
+    } as CSSProperties,
+    label: {
+      fontSize: "8px",
+      color: primaryColor,
+    },
+  };
+
+  return (
+    <Flex vertical align="center" gap={3}>
+      <canvas ref={canvasRef} width={size} height={size} style={styles.canvas} />
+      <div style={styles.meter}>
+        <div style={styles.meterFill} />
+      </div>
+      <Typography.Text style={styles.label}>
+        corr {correlation.toFixed(2)} / bal {balance >= 0 ? "R" : "L"} {Math.abs(balance * 100).toFixed(0)}%
+      </Typography.Text>
+    </Flex>
+  );
+};
+
+export default Goniometer;
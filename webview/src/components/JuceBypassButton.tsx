@@ -1,6 +1,5 @@
 import { type FC, useEffect, useRef, useState } from "react";
-// @ts-expect-error Juce does not have types
-import { getToggleState } from "juce-framework-frontend";
+import { getToggleState } from "../parameters";
 import { FaPowerOff } from "react-icons/fa";
 
 interface JuceBypassButtonProps {
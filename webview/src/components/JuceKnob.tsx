@@ -1,6 +1,5 @@
 import React, { type FC, useEffect, useState, useCallback, useMemo, useRef, type CSSProperties } from "react";
-// @ts-expect-error Juce does not have types
-import { getSliderState } from "juce-framework-frontend";
+import { getSliderState } from "../parameters";
 import { Flex } from "antd";
 import styled from "styled-components";
 
@@ -282,10 +281,11 @@ const JuceKnob: FC<JuceKnobProps> = ({
       if (disabled) return;
 
       e.preventDefault();
+      sliderState.beginGesture();
       startDrag(e.clientY, normalizedValue);
       lastMouseYRef.current = e.clientY;
     },
-    [disabled, startDrag, normalizedValue]
+    [disabled, sliderState, startDrag, normalizedValue]
   );
 
   const handleMouseMove = useCallback(
@@ -306,8 +306,9 @@ const JuceKnob: FC<JuceKnobProps> = ({
 
   const handleMouseUp = useCallback(() => {
     if (!dragState.isDragging) return;
+    sliderState.endGesture();
     endDrag();
-  }, [dragState.isDragging, endDrag]);
+  }, [dragState.isDragging, sliderState, endDrag]);
 
   const handleDoubleClick = useCallback(() => {
     if (disabled) return;
@@ -1,7 +1,6 @@
 import React, { type FC, useEffect, useRef, useState, useCallback, useMemo } from "react";
 import styled from "styled-components";
-// @ts-expect-error Juce does not have types
-import { getSliderState } from "juce-framework-frontend";
+import { getSliderState } from "../parameters";
 
 // Constants
 const DEFAULT_SENSITIVITY = 0.002;
@@ -362,10 +361,11 @@ const JuceSlider: FC<JuceSliderProps> = ({
 
       e.preventDefault();
       e.stopPropagation();
+      sliderState.beginGesture();
       startDrag(e.clientX, normalizedValue);
       lastMouseXRef.current = e.clientX;
     },
-    [disabled, startDrag, normalizedValue]
+    [disabled, sliderState, startDrag, normalizedValue]
   );
 
   const handleMouseMove = useCallback(
@@ -386,8 +386,9 @@ const JuceSlider: FC<JuceSliderProps> = ({
 
   const handleMouseUp = useCallback(() => {
     if (!dragState.isDragging) return;
+    sliderState.endGesture();
     endDrag();
-  }, [dragState.isDragging, endDrag]);
+  }, [dragState.isDragging, sliderState, endDrag]);
 
   // Handle double click to reset to mark value
   const handleDoubleClick = useCallback(() => {
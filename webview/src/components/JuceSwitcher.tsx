@@ -1,6 +1,5 @@
 import { type FC, useEffect, useRef, useState, useCallback, useMemo, type CSSProperties } from "react";
-// @ts-expect-error Juce does not have types
-import { getComboBoxState } from "juce-framework-frontend";
+import { getComboBoxState } from "../parameters";
 import { Flex, Typography } from "antd";
 
 interface JuceSwitcherProps {
@@ -10,7 +9,7 @@ interface JuceSwitcherProps {
   primaryColor: string;
   secondaryColor: string;
   hoverLockDuration?: number;
-  onChange?: (index: boolean) => void;
+  onChange?: (index: number) => void;
 }
 
 const JuceSwitcher: FC<JuceSwitcherProps> = ({ identifier, titles, level = 3, primaryColor, secondaryColor, hoverLockDuration = 500, onChange }) => {
@@ -27,7 +26,8 @@ const JuceSwitcher: FC<JuceSwitcherProps> = ({ identifier, titles, level = 3, pr
 
   // Memoized switcher state
   const switcherState = useMemo(() => {
-    const nextIndex = currentIndex === 0 ? 1 : 0;
+    // Each click steps to the next choice and wraps around
+    const nextIndex = (currentIndex + 1) % Math.max(titles.length, 1);
     const displayIndex = isHovered ? nextIndex : currentIndex;
     const shouldShowPreview = isHovered && !isHoverLocked;
 
@@ -36,7 +36,6 @@ const JuceSwitcher: FC<JuceSwitcherProps> = ({ identifier, titles, level = 3, pr
       displayIndex,
       shouldShowPreview,
       currentTitle: titles[displayIndex] || titles[0] || "Unknown",
-      nextIndexBoolean: currentIndex === 0,
     };
   }, [currentIndex, isHovered, isHoverLocked, titles]);
 
@@ -83,13 +82,12 @@ const JuceSwitcher: FC<JuceSwitcherProps> = ({ identifier, titles, level = 3, pr
   // Handle click event to toggle switcher state
   const handleClick = useCallback(() => {
     const newIndex = switcherState.nextIndex;
-    const newIndexBoolean = switcherState.nextIndexBoolean;
 
     // Update JUCE parameter
     comboBoxState.setChoiceIndex(newIndex);
 
     // Trigger onChange callback if provided
-    if (onChange) onChange(newIndexBoolean);
+    if (onChange) onChange(newIndex);
 
     // Lock hover to prevent immediate hover state after click
     setIsHovered(false);
@@ -102,7 +100,7 @@ const JuceSwitcher: FC<JuceSwitcherProps> = ({ identifier, titles, level = 3, pr
       // Restore hover state if mouse is still over
       if (isMouseOverRef.current) setIsHovered(true);
     }, hoverLockDuration);
-  }, [switcherState.nextIndex, switcherState.nextIndexBoolean, comboBoxState, onChange]);
+  }, [switcherState.nextIndex, comboBoxState, onChange]);
 
   return (
     <Flex justify="start" align="center" style={styles.container} onMouseEnter={handleMouseEnter} onMouseLeave={handleMouseLeave} onClick={handleClick}>
@@ -0,0 +1,45 @@
+import { type FC, useEffect, useState } from "react";
+import { Flex, Typography } from "antd";
+
+// Event sent by the editor a few times per second; loads are fractions of the block budget
+interface LoadEvent {
+  average: number;
+  peak: number;
+  overBudget: number;
+}
+
+interface LoadMeterProps {
+  primaryColor: string;
+  accentColor: string;
+}
+
+const formatPercent = (load: number): string => `${(load * 100).toFixed(1)}%`;
+
+const LoadMeter: FC<LoadMeterProps> = ({ primaryColor, accentColor }) => {
+  const [load, setLoad] = useState<LoadEvent>({ average: 0, peak: 0, overBudget: 0 });
+
+  // Subscribe to DSP load events
+  useEffect(() => {
+    // @ts-expect-error Juce does not have types
+    const backend = window.__JUCE__?.backend;
+    if (!backend) return;
+
+    const listenerId = backend.addEventListener("dspLoad", (event: LoadEvent) => setLoad(event));
+    return () => backend.removeEventListener(listenerId);
+  }, []);
+
+  const style = {
+    fontSize: "8px",
+    color: load.overBudget > 0 ? accentColor : primaryColor,
+  };
+
+  return (
+    <Flex vertical>
+      <Typography.Text style={style}>dsp {formatPercent(load.average)}</Typography.Text>
+      <Typography.Text style={style}>peak {formatPercent(load.peak)}</Typography.Text>
+      <Typography.Text style={style}>over {load.overBudget}</Typography.Text>
+    </Flex>
+  );
+};
+
+export default LoadMeter;
@@ -0,0 +1,144 @@
+// @ts-expect-error Juce does not have types
+import { getNativeFunction } from "juce-framework-frontend";
+
+// Parameter states for the controls, fed by one batched "parameters" event per editor frame
+// instead of a JUCE relay event per parameter change.
+//
+// Values set here update the control at once (optimistic) and go to the plugin straight away.
+// While a control is being dragged, host updates for it are ignored, so a late echo of an
+// earlier drag position cannot pull it back.
+
+// Sent by the editor once per frame with every parameter that changed, as normalised values
+type ParameterBatch = Record<string, number>;
+
+interface ParameterInfo {
+  id: string;
+  value: number;
+  choices?: string[];
+}
+
+type Listener = () => void;
+
+class ListenerList {
+  private listeners = new Map<number, Listener>();
+  private nextId = 0;
+
+  addListener(listener: Listener): number {
+    const id = this.nextId++;
+    this.listeners.set(id, listener);
+    return id;
+  }
+
+  removeListener(id: number) {
+    this.listeners.delete(id);
+  }
+
+  callListeners() {
+    this.listeners.forEach((listener) => listener());
+  }
+}
+
+// @ts-expect-error Juce does not have types
+const backend = window.__JUCE__?.backend;
+
+class ParameterState {
+  readonly valueChangedEvent = new ListenerList();
+  private normalisedValue = 0;
+  private numChoices = 0;
+  private isInGesture = false;
+
+  constructor(readonly identifier: string) {}
+
+  // Slider interface
+  getNormalisedValue(): number {
+    return this.normalisedValue;
+  }
+
+  setNormalisedValue(value: number) {
+    const clamped = Math.max(0, Math.min(1, value));
+    if (clamped !== this.normalisedValue) {
+      this.normalisedValue = clamped;
+      this.valueChangedEvent.callListeners();
+    }
+    backend?.emitEvent("setParameter", { id: this.identifier, value: clamped });
+  }
+
+  // Groups the values of one drag into a single host undo step
+  beginGesture() {
+    if (this.isInGesture) return;
+    this.isInGesture = true;
+    backend?.emitEvent("parameterGesture", { id: this.identifier, begin: true });
+  }
+
+  endGesture() {
+    if (!this.isInGesture) return;
+    this.isInGesture = false;
+    backend?.emitEvent("parameterGesture", { id: this.identifier, begin: false });
+  }
+
+  // Combo box interface
+  getChoiceIndex(): number {
+    return Math.round(this.normalisedValue * Math.max(0, this.numChoices - 1));
+  }
+
+  setChoiceIndex(index: number) {
+    this.setNormalisedValue(this.numChoices > 1 ? index / (this.numChoices - 1) : 0);
+  }
+
+  // Toggle interface
+  getValue(): boolean {
+    return this.normalisedValue >= 0.5;
+  }
+
+  setValue(value: boolean) {
+    this.setNormalisedValue(value ? 1 : 0);
+  }
+
+  // From the plugin
+  // Choice indices depend on the number of choices, so listeners are called even for an unchanged value
+  applyInfo(info: ParameterInfo) {
+    this.numChoices = info.choices?.length ?? 0;
+    if (!this.isInGesture) this.normalisedValue = info.value;
+    this.valueChangedEvent.callListeners();
+  }
+
+  applyHostValue(value: number) {
+    if (this.isInGesture || value === this.normalisedValue) return;
+    this.normalisedValue = value;
+    this.valueChangedEvent.callListeners();
+  }
+}
+
+const states = new Map<string, ParameterState>();
+
+const getState = (identifier: string): ParameterState => {
+  let state = states.get(identifier);
+  if (!state) {
+    state = new ParameterState(identifier);
+    states.set(identifier, state);
+  }
+  return state;
+};
+
+// Initial values and choices, then batches for as long as the page lives
+const initialise = async () => {
+  if (!backend) return;
+
+  backend.addEventListener("parameters", (batch: ParameterBatch) => {
+    for (const [identifier, value] of Object.entries(batch)) getState(identifier).applyHostValue(value);
+  });
+
+  try {
+    const getParameterInfo = getNativeFunction("getParameterInfo");
+    const infos: ParameterInfo[] = await getParameterInfo();
+    for (const info of infos) getState(info.id).applyInfo(info);
+  } catch (error) {
+    console.error("Failed to get parameter info:", error);
+  }
+};
+
+initialise();
+
+export const getSliderState = getState;
+export const getComboBoxState = getState;
+export const getToggleState = getState;